@@ -0,0 +1,585 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+// geoDataKernelsBench
+//
+// Micro-benchmarks for the GeoData conversion kernels in GeoDataKernels.h,
+// run over size sweeps so that each kernel can be compared against the
+// machine's memory bandwidth. The harness follows Google Benchmark's shape
+// (a State driving the timed loop, items/bytes processed per iteration) but is
+// self-contained so that it builds wherever the plug-in builds.
+//
+// Every kernel is reported in elements/sec and GB/s, where the byte count is
+// the minimum traffic the kernel has to move (reads + writes). A "Memcpy" row
+// per size gives a practical bandwidth ceiling for the same buffer sizes.
+//
+// Example:
+//   geoDataKernelsBench --max 10000000 --filter Expand
+
+#include "GeoDataKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+typedef chrono::steady_clock Clock;
+
+//------------------------------------------------------------------------------
+// Harness
+//------------------------------------------------------------------------------
+
+class State
+{
+public:
+    State(size_t range, double minSeconds) : _range(range), _minSeconds(minSeconds) {}
+
+    size_t range() const { return _range; }
+
+    // Drives the timed loop: while (state.KeepRunning()) { ... }
+    bool KeepRunning()
+    {
+        if (_iterations == 0 && !_running)
+        {
+            _running = true;
+            _start = Clock::now();
+            return true;
+        }
+
+        ++_iterations;
+        _seconds = chrono::duration<double>(Clock::now() - _start).count();
+        if (_seconds < _minSeconds)
+            return true;
+
+        _running = false;
+        return false;
+    }
+
+    void SetItemsProcessed(size_t items) { _items = items; }
+    void SetBytesProcessed(size_t bytes) { _bytes = bytes; }
+
+    size_t iterations() const { return _iterations; }
+    double seconds() const { return _seconds; }
+    size_t items() const { return _items; }
+    size_t bytes() const { return _bytes; }
+
+private:
+    size_t _range;
+    double _minSeconds;
+    size_t _iterations = 0;
+    bool _running = false;
+    double _seconds = 0.0;
+    size_t _items = 0;
+    size_t _bytes = 0;
+    Clock::time_point _start;
+};
+
+struct Benchmark
+{
+    string name;
+    function<void(State &)> fn;
+};
+
+vector<Benchmark> &_Registry()
+{
+    static vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar
+{
+    Registrar(const char *name, function<void(State &)> fn)
+    {
+        _Registry().push_back({name, fn});
+    }
+};
+
+#define KERNEL_BENCHMARK(fn) static Registrar _registrar_##fn(#fn, fn)
+
+// Keeps the optimiser from discarding a result.
+template <typename T>
+inline void _DoNotOptimize(T const &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+inline void _ClobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Inputs
+//------------------------------------------------------------------------------
+
+// Face-vertex indices of a quad grid with roughly numFaceVertices / 4 points,
+// which is the access pattern GeoData sees for a typical quad mesh.
+vector<int> _QuadGridIndices(size_t numFaceVertices, size_t *numPointsOut = nullptr)
+{
+    size_t faces = max<size_t>(numFaceVertices / 4, 1);
+    size_t columns = 1;
+    while (columns * columns < faces)
+        ++columns;
+    size_t stride = columns + 1;
+
+    vector<int> indices(numFaceVertices);
+    for (size_t i = 0; i < numFaceVertices; ++i)
+    {
+        size_t face = i / 4;
+        size_t x = face % columns;
+        size_t y = face / columns;
+        size_t v0 = y * stride + x;
+        static const size_t corner[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+        indices[i] = int(v0 + corner[i % 4][0] + corner[i % 4][1] * stride);
+    }
+
+    if (numPointsOut)
+        *numPointsOut = (columns + 1) * ((faces + columns - 1) / columns + 1);
+    return indices;
+}
+
+vector<float> _Points(size_t numPoints)
+{
+    vector<float> points(numPoints * 3);
+    for (size_t i = 0; i < points.size(); ++i)
+        points[i] = float(i % 1021) * 0.25f;
+    return points;
+}
+
+//------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------
+
+void Memcpy(State &state)
+{
+    size_t n = state.range();
+    vector<int> src(n, 1), dst(n);
+    while (state.KeepRunning())
+    {
+        memcpy(dst.data(), src.data(), n * sizeof(int));
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(2 * n * sizeof(int));
+}
+KERNEL_BENCHMARK(Memcpy);
+
+void ExpandVertexToFaceVarying(State &state)
+{
+    size_t n = state.range();
+    size_t numPoints = 0;
+    vector<int> vertexIndices = _QuadGridIndices(n, &numPoints);
+    vector<int> perVertex(numPoints);
+    GeoDataKernels::Iota(perVertex.data(), perVertex.size());
+    vector<int> out(n);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::ExpandVertexToFaceVarying(vertexIndices.data(), n, perVertex.data(), out.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    // index read + gathered read + write
+    state.SetBytesProcessed(3 * n * sizeof(int));
+}
+KERNEL_BENCHMARK(ExpandVertexToFaceVarying);
+
+// Uniform primvar expansion over a mesh of state.range() faces, all with
+// the same number of vertices. Arity 0 takes the generic path, which walks
+// the face counts; the fixed arity paths are what GeoData uses for
+// all-triangle and all-quad meshes. Items are faces.
+template <int FaceSize, int Arity>
+void _ExpandUniform(State &state)
+{
+    size_t faces = state.range();
+    size_t n = faces * FaceSize;
+    vector<int> faceCounts(faces, FaceSize);
+    vector<int> vertexIndices(n);
+    GeoDataKernels::Iota(vertexIndices.data(), n);
+    vector<int> out(n);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::ExpandToFaceVarying<GeoDataKernels::Interpolation::Uniform, false, Arity>(
+            faceCounts.data(), faces, vertexIndices.data(), n, nullptr, out.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(faces);
+    // face counts read (generic path only) + write
+    state.SetBytesProcessed((Arity == 0 ? faces * sizeof(int) : 0) + n * sizeof(int));
+}
+
+void ExpandUniformTrianglesGeneric(State &state) { _ExpandUniform<3, 0>(state); }
+void ExpandUniformTriangles(State &state) { _ExpandUniform<3, 3>(state); }
+void ExpandUniformQuadsGeneric(State &state) { _ExpandUniform<4, 0>(state); }
+void ExpandUniformQuads(State &state) { _ExpandUniform<4, 4>(state); }
+KERNEL_BENCHMARK(ExpandUniformTrianglesGeneric);
+KERNEL_BENCHMARK(ExpandUniformTriangles);
+KERNEL_BENCHMARK(ExpandUniformQuadsGeneric);
+KERNEL_BENCHMARK(ExpandUniformQuads);
+
+void UniformFaceArity(State &state)
+{
+    size_t faces = state.range();
+    vector<int> faceCounts(faces, 4);
+    while (state.KeepRunning())
+    {
+        _DoNotOptimize(GeoDataKernels::UniformFaceArity(faceCounts.data(), faces));
+    }
+    state.SetItemsProcessed(faces);
+    state.SetBytesProcessed(faces * sizeof(int));
+}
+KERNEL_BENCHMARK(UniformFaceArity);
+
+void InterleaveUVs(State &state)
+{
+    size_t n = state.range();
+    vector<float> u(n, 0.25f), v(n, 0.75f), out(n * 2);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::InterleaveUVs(u.data(), v.data(), n, out.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(4 * n * sizeof(float));
+}
+KERNEL_BENCHMARK(InterleaveUVs);
+
+void MaxIndex(State &state)
+{
+    size_t n = state.range();
+    vector<int> vertexIndices = _QuadGridIndices(n);
+    while (state.KeepRunning())
+    {
+        _DoNotOptimize(GeoDataKernels::MaxIndex(vertexIndices.data(), n));
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(n * sizeof(int));
+}
+KERNEL_BENCHMARK(MaxIndex);
+
+void Iota(State &state)
+{
+    size_t n = state.range();
+    vector<int> out(n);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::Iota(out.data(), n);
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(n * sizeof(int));
+}
+KERNEL_BENCHMARK(Iota);
+
+void TransformPoints(State &state)
+{
+    size_t n = state.range();
+    vector<float> points = _Points(n);
+    // Identity-like but not identity, so that nothing folds away.
+    const double m[16] = {1.0, 0.0, 0.0, 0.0,
+                          0.0, 1.0, 0.0, 0.0,
+                          0.0, 0.0, 1.0, 0.0,
+                          0.5, -0.5, 0.25, 1.0};
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::TransformPoints(points.data(), n, m);
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(2 * n * 3 * sizeof(float));
+}
+KERNEL_BENCHMARK(TransformPoints);
+
+void SwizzleZUpToYUp(State &state)
+{
+    size_t n = state.range();
+    vector<float> points = _Points(n);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::SwizzleZUpToYUp(points.data(), n);
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(2 * n * 3 * sizeof(float));
+}
+KERNEL_BENCHMARK(SwizzleZUpToYUp);
+
+struct Vec3f
+{
+    float v[3];
+};
+
+void FlattenTuples(State &state)
+{
+    size_t n = state.range();
+    vector<Vec3f> src(n, Vec3f{{1.0f, 2.0f, 3.0f}});
+    vector<float> dst(n * 3);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::FlattenTuples<3>(src.data(), n, dst.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(2 * n * sizeof(Vec3f));
+}
+KERNEL_BENCHMARK(FlattenTuples);
+
+// Normals of a quad grid of state.range() faces. Items are faces.
+void FaceNormals(State &state)
+{
+    size_t faces = state.range();
+    size_t numPoints = 0;
+    vector<int> vertexIndices = _QuadGridIndices(faces * 4, &numPoints);
+    vector<int> faceOffsets(faces + 1);
+    for (size_t i = 0; i <= faces; ++i)
+        faceOffsets[i] = int(i * 4);
+    vector<float> points = _Points(numPoints);
+    vector<float> out(faces * 3);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::FaceNormals(points.data(), vertexIndices.data(), faceOffsets.data(), nullptr, false,
+                                    0, faces, out.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(faces);
+    // indices + gathered points + normals
+    state.SetBytesProcessed(faces * (4 * sizeof(int) + 4 * 3 * sizeof(float) + 3 * sizeof(float)));
+}
+KERNEL_BENCHMARK(FaceNormals);
+
+// Area test of the faces of a quad grid, none of which is degenerate, so
+// every face is tested. Items are faces.
+void ClearFacesWithArea(State &state)
+{
+    size_t faces = state.range();
+    size_t numPoints = 0;
+    vector<int> vertexIndices = _QuadGridIndices(faces * 4, &numPoints);
+    vector<int> faceOffsets(faces + 1);
+    for (size_t i = 0; i <= faces; ++i)
+        faceOffsets[i] = int(i * 4);
+    vector<float> points = _Points(numPoints);
+    vector<unsigned char> zeroArea(faces);
+    while (state.KeepRunning())
+    {
+        fill(zeroArea.begin(), zeroArea.end(), 1);
+        GeoDataKernels::ClearFacesWithArea(points.data(), vertexIndices.data(), faceOffsets.data(),
+                                           0, faces, zeroArea.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(faces);
+    // indices + gathered points + flags
+    state.SetBytesProcessed(faces * (4 * sizeof(int) + 4 * 3 * sizeof(float) + 2));
+}
+KERNEL_BENCHMARK(ClearFacesWithArea);
+
+// Sort keys of the faces of a quad grid: their centres, then the Morton
+// code of the cell each centre falls in. Items are faces.
+void MortonFaceKeys(State &state)
+{
+    size_t faces = state.range();
+    size_t numPoints = 0;
+    vector<int> vertexIndices = _QuadGridIndices(faces * 4, &numPoints);
+    vector<int> faceOffsets(faces + 1);
+    for (size_t i = 0; i <= faces; ++i)
+        faceOffsets[i] = int(i * 4);
+    vector<float> points = _Points(numPoints);
+    vector<float> centres(faces * 3);
+    vector<uint64_t> keys(faces);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::FaceCentres(points.data(), 3, vertexIndices.data(), faceOffsets.data(), 0, faces, centres.data());
+        for (size_t face = 0; face < faces; ++face)
+        {
+            const float *c = centres.data() + face * 3;
+            keys[face] = GeoDataKernels::Morton48(unsigned(c[0]) & 0xffff, unsigned(c[1]) & 0xffff, unsigned(c[2]) & 0xffff);
+        }
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(faces);
+    // indices + gathered points + centres + keys
+    state.SetBytesProcessed(faces * (4 * sizeof(int) + 4 * 3 * sizeof(float) + 3 * sizeof(float) + sizeof(uint64_t)));
+}
+KERNEL_BENCHMARK(MortonFaceKeys);
+
+// UDIM tiles of the faces of a quad grid whose uvs span 4x2 tiles. Items
+// are faces.
+void MarkUdimTiles(State &state)
+{
+    size_t faces = state.range();
+    size_t numPoints = 0;
+    vector<int> vertexIndices = _QuadGridIndices(faces * 4, &numPoints);
+    vector<int> faceOffsets(faces + 1);
+    for (size_t i = 0; i <= faces; ++i)
+        faceOffsets[i] = int(i * 4);
+    vector<float> uvs(numPoints * 2);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        uvs[i * 2] = 4.0f * float(i) / float(numPoints);
+        uvs[i * 2 + 1] = float(i % 2) + 0.5f;
+    }
+    GeoDataKernels::UdimTiles tiles;
+    while (state.KeepRunning())
+    {
+        tiles.reset();
+        GeoDataKernels::MarkUdimTiles(uvs.data(), vertexIndices.data(), faceOffsets.data(), 0, faces, tiles);
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(faces);
+    // indices + gathered uvs
+    state.SetBytesProcessed(faces * (4 * sizeof(int) + 4 * 2 * sizeof(float)));
+}
+KERNEL_BENCHMARK(MarkUdimTiles);
+
+// One smooth group per grid point, gathering the normals of the four
+// faces around it. Items are groups.
+void GatherGroupNormals(State &state)
+{
+    size_t groups = state.range();
+    size_t columns = 1;
+    while (columns * columns < groups)
+        ++columns;
+    const size_t around[4] = {0, 1, columns, columns + 1};
+    vector<int> groupOffsets(groups + 1), groupFaces(groups * 4);
+    for (size_t g = 0; g < groups; ++g)
+    {
+        groupOffsets[g] = int(g * 4);
+        for (size_t k = 0; k < 4; ++k)
+            groupFaces[g * 4 + k] = int((g + around[k]) % groups);
+    }
+    groupOffsets[groups] = int(groups * 4);
+    vector<float> faceNormals = _Points(groups), out(groups * 3);
+    while (state.KeepRunning())
+    {
+        GeoDataKernels::GatherGroupNormals(faceNormals.data(), groupOffsets.data(), groupFaces.data(),
+                                           0, groups, out.data());
+        _ClobberMemory();
+    }
+    state.SetItemsProcessed(groups);
+    // offsets + faces + gathered normals + normals
+    state.SetBytesProcessed(groups * (5 * sizeof(int) + 4 * 3 * sizeof(float) + 3 * sizeof(float)));
+}
+KERNEL_BENCHMARK(GatherGroupNormals);
+
+void Hash64(State &state)
+{
+    size_t n = state.range();
+    vector<float> points = _Points(n);
+    while (state.KeepRunning())
+    {
+        _DoNotOptimize(GeoDataKernels::Hash64(points.data(), points.size() * sizeof(float), 0));
+    }
+    state.SetItemsProcessed(n);
+    state.SetBytesProcessed(n * 3 * sizeof(float));
+}
+KERNEL_BENCHMARK(Hash64);
+
+void _Usage()
+{
+    fprintf(stderr,
+        "usage: geoDataKernelsBench [options]\n"
+        "  --min N          smallest element count (default 1000)\n"
+        "  --max N          largest element count (default 50000000)\n"
+        "  --min-time S     minimum seconds per measurement (default 0.2)\n"
+        "  --filter TEXT    only run benchmarks whose name contains TEXT\n");
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv)
+{
+    size_t minSize = 1000;
+    size_t maxSize = 50000000;
+    double minTime = 0.2;
+    string filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--min" && hasValue)             minSize = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max" && hasValue)        maxSize = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--min-time" && hasValue)   minTime = atof(argv[++i]);
+        else if (arg == "--filter" && hasValue)     filter = argv[++i];
+        else
+        {
+            _Usage();
+            return 1;
+        }
+    }
+
+    // 1k, 10k, ... 10M, then 50M
+    vector<size_t> sizes;
+    for (size_t size = 1000; size <= 10000000; size *= 10)
+        sizes.push_back(size);
+    sizes.push_back(50000000);
+    sizes.erase(remove_if(sizes.begin(), sizes.end(),
+                          [&](size_t size) { return size < minSize || size > maxSize; }),
+                sizes.end());
+
+    printf("%-36s %14s %12s %16s %10s\n", "benchmark", "time/iter", "iterations", "elements/s", "GB/s");
+    for (const Benchmark &benchmark : _Registry())
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == string::npos)
+            continue;
+
+        for (size_t size : sizes)
+        {
+            State state(size, minTime);
+            benchmark.fn(state);
+
+            double perIteration = state.seconds() / double(state.iterations());
+            string name = benchmark.name + "/" + to_string(size);
+            printf("%-36s %11.3f us %12zu %16.4g %10.2f\n",
+                   name.c_str(),
+                   perIteration * 1e6,
+                   state.iterations(),
+                   double(state.items()) / perIteration,
+                   double(state.bytes()) / perIteration / 1e9);
+            fflush(stdout);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,834 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+// usdImportBench
+//
+// Generates a synthetic USD stage and runs it through the same
+// UsdReader::GetSettings / UsdReader::Load path the Mari plug-in uses, against
+// a host stand-in that records every call made to it. Reports wall time,
+// per-phase time, peak RSS and the number of bytes handed to the host so that
+// importer changes can be compared run to run.
+//
+// Example:
+//   usdImportBench --gprims 40000 --faces 200 --uv faceVarying --frames 3
+//   usdImportBench --gprims 5000 --threads 8
+
+#include "UsdReader.h"
+#include "MariHostConfig.h"
+
+#include "pxr/base/gf/vec3d.h"
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/vt/array.h"
+#include "pxr/usd/sdf/path.h"
+#include "pxr/usd/usd/references.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/mesh.h"
+#include "pxr/usd/usdGeom/metrics.h"
+#include "pxr/usd/usdGeom/primvarsAPI.h"
+#include "pxr/usd/usdGeom/tokens.h"
+#include "pxr/usd/usdGeom/xform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+
+typedef chrono::steady_clock Clock;
+
+double _MillisecondsSince(Clock::time_point start)
+{
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+size_t _PeakRssBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return size_t(usage.ru_maxrss);
+#else
+    return size_t(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Options
+//------------------------------------------------------------------------------
+
+struct BenchOptions
+{
+    int gprims = 1000;              // number of meshes to author
+    int faces = 100;                // approximate faces per mesh
+    string polyMix = "quad";        // tri, quad or mixed
+    string uvInterpolation = "faceVarying";     // none, vertex, faceVarying or split
+    string normalInterpolation = "none";        // none, vertex or faceVarying
+    int depth = 2;                  // number of Xform levels above the meshes
+    int prototypes = 0;             // > 0 -> meshes are instances of this many prototypes
+    int copies = 0;                 // > 0 -> meshes are plain copies of this many meshes, moved by a transform
+    int frames = 1;                 // number of animated frames to author and import
+    bool subdiv = false;            // author catmullClark + creases/corners/holes
+    string format = "usdc";         // usdc or usda
+    int iterations = 3;             // number of Load calls
+    int threads = 0;                // > 0 -> also run this many Load calls at once
+    bool copyBuffers = true;        // host copies incoming buffers, like Mari does
+    string keepFile;                // write the stage here and keep it
+};
+
+void _Usage()
+{
+    fprintf(stderr,
+        "usage: usdImportBench [options]\n"
+        "  --gprims N           number of meshes (default 1000)\n"
+        "  --faces N            approximate faces per mesh (default 100)\n"
+        "  --poly tri|quad|mixed  polygon mix (default quad)\n"
+        "  --uv none|vertex|faceVarying|split uv interpolation (default faceVarying), split\n"
+        "                                     writes indexed faceVarying u_st and v_st floats\n"
+        "  --normals none|vertex|faceVarying  normal interpolation (default none)\n"
+        "  --depth N            Xform hierarchy depth above the meshes (default 2)\n"
+        "  --instances N        author meshes as instances of N prototypes (default 0, off)\n"
+        "  --copies N           author meshes as non-instanced copies of N meshes (default 0, off)\n"
+        "  --frames N           animated frames to author and import (default 1)\n"
+        "  --subdiv             author catmullClark meshes with creases, corners and holes\n"
+        "  --format usdc|usda   file format (default usdc)\n"
+        "  --iterations N       number of Load calls (default 3)\n"
+        "  --threads N          also run N Load calls concurrently, one reader per thread (default 0, off)\n"
+        "  --no-copy            do not copy buffers in the host stand-in\n"
+        "  --keep PATH          write the stage to PATH and keep it\n");
+}
+
+bool _ParseArgs(int argc, char **argv, BenchOptions &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--gprims" && hasValue)              opts.gprims = atoi(argv[++i]);
+        else if (arg == "--faces" && hasValue)          opts.faces = atoi(argv[++i]);
+        else if (arg == "--poly" && hasValue)           opts.polyMix = argv[++i];
+        else if (arg == "--uv" && hasValue)             opts.uvInterpolation = argv[++i];
+        else if (arg == "--normals" && hasValue)        opts.normalInterpolation = argv[++i];
+        else if (arg == "--depth" && hasValue)          opts.depth = atoi(argv[++i]);
+        else if (arg == "--instances" && hasValue)      opts.prototypes = atoi(argv[++i]);
+        else if (arg == "--copies" && hasValue)         opts.copies = atoi(argv[++i]);
+        else if (arg == "--frames" && hasValue)         opts.frames = atoi(argv[++i]);
+        else if (arg == "--subdiv")                     opts.subdiv = true;
+        else if (arg == "--format" && hasValue)         opts.format = argv[++i];
+        else if (arg == "--iterations" && hasValue)     opts.iterations = atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue)        opts.threads = atoi(argv[++i]);
+        else if (arg == "--no-copy")                    opts.copyBuffers = false;
+        else if (arg == "--keep" && hasValue)           opts.keepFile = argv[++i];
+        else
+        {
+            _Usage();
+            return false;
+        }
+    }
+
+    opts.gprims = max(opts.gprims, 1);
+    opts.faces = max(opts.faces, 1);
+    opts.depth = max(opts.depth, 0);
+    opts.frames = max(opts.frames, 1);
+    opts.iterations = max(opts.iterations, 1);
+    opts.threads = max(opts.threads, 0);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Synthetic scene generator
+//------------------------------------------------------------------------------
+
+// Topology shared by every mesh: a grid of cells, each emitted as a quad or
+// split into two triangles according to the polygon mix.
+struct GridMesh
+{
+    VtIntArray faceVertexCounts;
+    VtIntArray faceVertexIndices;
+    VtVec3fArray points;
+    VtVec2fArray vertexUVs;
+    int columns = 0;
+};
+
+GridMesh _BuildGridMesh(const BenchOptions &opts)
+{
+    GridMesh grid;
+
+    // Two triangles per cell for "tri", one quad otherwise; "mixed" splits
+    // every third cell.
+    int cells = opts.polyMix == "tri" ? max(opts.faces / 2, 1) : opts.faces;
+    int columns = max(int(sqrt(double(cells))), 1);
+    int rows = (cells + columns - 1) / columns;
+    grid.columns = columns;
+
+    for (int y = 0; y <= rows; ++y)
+    {
+        for (int x = 0; x <= columns; ++x)
+        {
+            grid.points.push_back(GfVec3f(float(x), float(y), 0.0f));
+            grid.vertexUVs.push_back(GfVec2f(float(x) / columns, float(y) / rows));
+        }
+    }
+
+    int stride = columns + 1;
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        int x = cell % columns;
+        int y = cell / columns;
+        int v0 = y * stride + x;
+        int v1 = v0 + 1;
+        int v2 = v1 + stride;
+        int v3 = v0 + stride;
+
+        bool split = opts.polyMix == "tri" || (opts.polyMix == "mixed" && cell % 3 == 0);
+        if (split)
+        {
+            grid.faceVertexCounts.push_back(3);
+            grid.faceVertexIndices.push_back(v0);
+            grid.faceVertexIndices.push_back(v1);
+            grid.faceVertexIndices.push_back(v2);
+            grid.faceVertexCounts.push_back(3);
+            grid.faceVertexIndices.push_back(v0);
+            grid.faceVertexIndices.push_back(v2);
+            grid.faceVertexIndices.push_back(v3);
+        }
+        else
+        {
+            grid.faceVertexCounts.push_back(4);
+            grid.faceVertexIndices.push_back(v0);
+            grid.faceVertexIndices.push_back(v1);
+            grid.faceVertexIndices.push_back(v2);
+            grid.faceVertexIndices.push_back(v3);
+        }
+    }
+
+    return grid;
+}
+
+void _AuthorMesh(const UsdStageRefPtr &stage,
+                 const SdfPath &path,
+                 const GridMesh &grid,
+                 const BenchOptions &opts,
+                 int meshIndex)
+{
+    UsdGeomMesh mesh = UsdGeomMesh::Define(stage, path);
+    mesh.CreateFaceVertexCountsAttr().Set(grid.faceVertexCounts);
+    mesh.CreateFaceVertexIndicesAttr().Set(grid.faceVertexIndices);
+
+    // Offset every mesh so the transforms and bounds are not all identical.
+    GfVec3f offset(float(meshIndex % 100) * 2.0f, float(meshIndex / 100) * 2.0f, 0.0f);
+    UsdAttribute pointsAttr = mesh.CreatePointsAttr();
+    for (int frame = 1; frame <= opts.frames; ++frame)
+    {
+        VtVec3fArray points = grid.points;
+        for (GfVec3f &p : points)
+        {
+            p[0] += offset[0];
+            p[1] += offset[1];
+            p[2] += 0.01f * float(frame - 1);
+        }
+
+        if (opts.frames > 1)
+            pointsAttr.Set(points, UsdTimeCode(frame));
+        else
+            pointsAttr.Set(points);
+    }
+
+    UsdGeomPrimvarsAPI primvarsApi(mesh.GetPrim());
+    if (opts.uvInterpolation == "vertex")
+    {
+        UsdGeomPrimvar st = primvarsApi.CreatePrimvar(TfToken("st"),
+                SdfValueTypeNames->TexCoord2fArray, UsdGeomTokens->vertex);
+        st.Set(grid.vertexUVs);
+    }
+    else if (opts.uvInterpolation == "faceVarying")
+    {
+        UsdGeomPrimvar st = primvarsApi.CreatePrimvar(TfToken("st"),
+                SdfValueTypeNames->TexCoord2fArray, UsdGeomTokens->faceVarying);
+        st.Set(grid.vertexUVs);
+        st.SetIndices(grid.faceVertexIndices);
+    }
+    else if (opts.uvInterpolation == "split")
+    {
+        VtFloatArray u(grid.vertexUVs.size()), v(grid.vertexUVs.size());
+        for (size_t i = 0; i < grid.vertexUVs.size(); ++i)
+        {
+            u[i] = grid.vertexUVs[i][0];
+            v[i] = grid.vertexUVs[i][1];
+        }
+        UsdGeomPrimvar uPrimvar = primvarsApi.CreatePrimvar(TfToken("u_st"),
+                SdfValueTypeNames->FloatArray, UsdGeomTokens->faceVarying);
+        uPrimvar.Set(u);
+        uPrimvar.SetIndices(grid.faceVertexIndices);
+        UsdGeomPrimvar vPrimvar = primvarsApi.CreatePrimvar(TfToken("v_st"),
+                SdfValueTypeNames->FloatArray, UsdGeomTokens->faceVarying);
+        vPrimvar.Set(v);
+        vPrimvar.SetIndices(grid.faceVertexIndices);
+    }
+
+    if (opts.normalInterpolation == "vertex")
+    {
+        mesh.CreateNormalsAttr().Set(VtVec3fArray(grid.points.size(), GfVec3f(0.0f, 0.0f, 1.0f)));
+        mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
+    }
+    else if (opts.normalInterpolation == "faceVarying")
+    {
+        mesh.CreateNormalsAttr().Set(VtVec3fArray(grid.faceVertexIndices.size(), GfVec3f(0.0f, 0.0f, 1.0f)));
+        mesh.SetNormalsInterpolation(UsdGeomTokens->faceVarying);
+    }
+
+    if (opts.subdiv)
+    {
+        mesh.CreateSubdivisionSchemeAttr().Set(UsdGeomTokens->catmullClark);
+
+        // Crease along the first row of the grid, a corner and a hole.
+        VtIntArray creaseIndices;
+        for (int x = 0; x <= grid.columns; ++x)
+            creaseIndices.push_back(x);
+        mesh.CreateCreaseIndicesAttr().Set(creaseIndices);
+        mesh.CreateCreaseLengthsAttr().Set(VtIntArray(1, int(creaseIndices.size())));
+        mesh.CreateCreaseSharpnessesAttr().Set(VtFloatArray(1, 2.0f));
+        mesh.CreateCornerIndicesAttr().Set(VtIntArray(1, 0));
+        mesh.CreateCornerSharpnessesAttr().Set(VtFloatArray(1, 10.0f));
+        mesh.CreateHoleIndicesAttr().Set(VtIntArray(1, int(grid.faceVertexCounts.size()) - 1));
+    }
+    else
+    {
+        mesh.CreateSubdivisionSchemeAttr().Set(UsdGeomTokens->none);
+    }
+}
+
+// Returns the parent path for gprim `index` in a hierarchy `depth` levels deep
+// with an even branching factor.
+SdfPath _GroupPath(const SdfPath &root, int index, int count, int depth)
+{
+    SdfPath path = root;
+    if (depth == 0)
+        return path;
+
+    int branching = max(int(ceil(pow(double(count), 1.0 / (depth + 1)))), 1);
+    int divisor = 1;
+    for (int level = 0; level < depth; ++level)
+        divisor *= branching;
+
+    for (int level = 0; level < depth; ++level)
+    {
+        int group = (index / divisor) % branching;
+        divisor /= branching;
+        path = path.AppendChild(TfToken(TfStringPrintf("g%d_%d", level, group)));
+    }
+    return path;
+}
+
+void _GenerateStage(const BenchOptions &opts, const string &fileName)
+{
+    UsdStageRefPtr stage = UsdStage::CreateNew(fileName);
+    UsdGeomSetStageUpAxis(stage, UsdGeomTokens->y);
+    if (opts.frames > 1)
+    {
+        stage->SetStartTimeCode(1);
+        stage->SetEndTimeCode(opts.frames);
+    }
+
+    GridMesh grid = _BuildGridMesh(opts);
+
+    SdfPath rootPath("/root");
+    UsdGeomXform root = UsdGeomXform::Define(stage, rootPath);
+    stage->SetDefaultPrim(root.GetPrim());
+
+    // Prototypes live under an abstract class prim so that they are not
+    // traversed themselves.
+    SdfPath prototypesPath("/prototypes");
+    if (opts.prototypes > 0)
+    {
+        stage->CreateClassPrim(prototypesPath);
+        for (int p = 0; p < opts.prototypes; ++p)
+        {
+            SdfPath protoPath = prototypesPath.AppendChild(TfToken(TfStringPrintf("proto%d", p)));
+            UsdGeomXform::Define(stage, protoPath);
+            _AuthorMesh(stage, protoPath.AppendChild(TfToken("geo")), grid, opts, p);
+        }
+    }
+
+    for (int i = 0; i < opts.gprims; ++i)
+    {
+        SdfPath parent = _GroupPath(rootPath, i, opts.gprims, opts.depth);
+        for (SdfPath ancestor = parent; ancestor != rootPath; ancestor = ancestor.GetParentPath())
+        {
+            if (stage->GetPrimAtPath(ancestor))
+                break;
+            UsdGeomXform::Define(stage, ancestor);
+        }
+
+        SdfPath path = parent.AppendChild(TfToken(TfStringPrintf("mesh%d", i)));
+        if (opts.prototypes > 0)
+        {
+            UsdGeomXform instance = UsdGeomXform::Define(stage, path);
+            instance.GetPrim().GetReferences().AddInternalReference(
+                prototypesPath.AppendChild(TfToken(TfStringPrintf("proto%d", i % opts.prototypes))));
+            instance.GetPrim().SetInstanceable(true);
+        }
+        else if (opts.copies > 0)
+        {
+            // Same authored data as mesh i % copies, somewhere else
+            _AuthorMesh(stage, path, grid, opts, i % opts.copies);
+            UsdGeomMesh(stage->GetPrimAtPath(path)).AddTranslateOp().Set(GfVec3d(0.0, 0.0, 2.0 * (i / opts.copies)));
+        }
+        else
+        {
+            _AuthorMesh(stage, path, grid, opts, i);
+        }
+    }
+
+    stage->Save();
+}
+
+//------------------------------------------------------------------------------
+// Recording host stand-in
+//------------------------------------------------------------------------------
+
+// The host suite is a table of C function pointers without user data, so the
+// recorder is process-global. Every host call locks it, for --threads.
+struct HostRecord
+{
+    map<string, size_t> calls;
+    size_t bytesCreateGeoData = 0;
+    size_t bytesSetGeoDataForFrame = 0;
+    size_t meshObjects = 0;
+    size_t faces = 0;
+    uintptr_t nextHandle = 1;
+    double hostMilliseconds = 0.0;
+    bool copyBuffers = true;
+    vector<char> sink;
+
+    map<string, string> stringAttributes;
+    map<string, int> intAttributes;
+    map<string, string> writtenAttributes;
+
+    void Reset()
+    {
+        calls.clear();
+        bytesCreateGeoData = 0;
+        bytesSetGeoDataForFrame = 0;
+        meshObjects = 0;
+        faces = 0;
+        hostMilliseconds = 0.0;
+        writtenAttributes.clear();
+    }
+
+    size_t TotalCalls() const
+    {
+        size_t total = 0;
+        for (const auto &it : calls)
+            total += it.second;
+        return total;
+    }
+};
+
+HostRecord sRecord;
+mutex sRecordMutex;
+
+template <typename FN>
+struct HostFnResult;
+
+template <typename R, typename... ARGS>
+struct HostFnResult<R (*)(ARGS...)>
+{
+    typedef R type;
+};
+
+#define HOST_RESULT(member, value) \
+    static_cast<HostFnResult<decltype(MriGeoReaderHost::member)>::type>(value)
+
+template <typename HANDLE>
+HANDLE _MakeHandle(uintptr_t value)
+{
+    if constexpr (is_pointer<HANDLE>::value)
+        return reinterpret_cast<HANDLE>(value);
+    else
+        return static_cast<HANDLE>(value);
+}
+
+// Takes a buffer as the host would. Copying is what Mari does with incoming
+// channel data, so it is included in the host time by default.
+void _Ingest(const void *pData, size_t size)
+{
+    if (sRecord.copyBuffers && size > 0)
+    {
+        if (sRecord.sink.size() < size)
+            sRecord.sink.resize(size);
+        memcpy(sRecord.sink.data(), pData, size);
+    }
+}
+
+struct HostTimer
+{
+    Clock::time_point start = Clock::now();
+    ~HostTimer() { sRecord.hostMilliseconds += _MillisecondsSince(start); }
+};
+
+void _Trace(const char *, ...)
+{
+}
+
+MriGeoReaderHost _MakeRecordingHost()
+{
+    MriGeoReaderHost host;
+    memset(&host, 0, sizeof(host));
+
+    host.trace = &_Trace;
+
+    host.createGeoData = [](auto, auto pData, auto size, auto, auto, auto pDataOut)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["createGeoData"];
+        sRecord.bytesCreateGeoData += size_t(size);
+        _Ingest(pData, size_t(size));
+        *pDataOut = _MakeHandle<typename remove_pointer<decltype(pDataOut)>::type>(sRecord.nextHandle++);
+        return HOST_RESULT(createGeoData, MRI_GPR_SUCCEEDED);
+    };
+
+    host.setGeoDataForFrame = [](auto, auto, auto, auto pData, auto size)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["setGeoDataForFrame"];
+        sRecord.bytesSetGeoDataForFrame += size_t(size);
+        _Ingest(pData, size_t(size));
+        return HOST_RESULT(setGeoDataForFrame, MRI_GPR_SUCCEEDED);
+    };
+
+    host.createMeshObject = [](auto, auto, auto numFaces, auto pObjectOut)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["createMeshObject"];
+        ++sRecord.meshObjects;
+        sRecord.faces += size_t(numFaces);
+        *pObjectOut = _MakeHandle<typename remove_pointer<decltype(pObjectOut)>::type>(sRecord.nextHandle++);
+        return HOST_RESULT(createMeshObject, MRI_GPR_SUCCEEDED);
+    };
+
+    host.addGeoDataToObject = [](auto, auto, auto)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["addGeoDataToObject"];
+        return HOST_RESULT(addGeoDataToObject, MRI_GPR_SUCCEEDED);
+    };
+
+    host.setSubdivisionOnMeshObject = [](auto, auto, auto, auto, auto, auto, auto)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["setSubdivisionOnMeshObject"];
+        return HOST_RESULT(setSubdivisionOnMeshObject, MRI_GPR_SUCCEEDED);
+    };
+
+    host.createSelectionGroup = [](auto, auto, auto pGroupOut)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["createSelectionGroup"];
+        *pGroupOut = _MakeHandle<typename remove_pointer<decltype(pGroupOut)>::type>(sRecord.nextHandle++);
+        return HOST_RESULT(createSelectionGroup, MRI_GPR_SUCCEEDED);
+    };
+
+    host.addFacesToSelectionGroup = [](auto, auto, auto, auto pFaces, auto numFaces)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        HostTimer timer;
+        ++sRecord.calls["addFacesToSelectionGroup"];
+        _Ingest(pFaces, size_t(numFaces) * sizeof(*pFaces));
+        return HOST_RESULT(addFacesToSelectionGroup, MRI_GPR_SUCCEEDED);
+    };
+
+    host.setEntityType = [](auto, auto)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        ++sRecord.calls["setEntityType"];
+        return HOST_RESULT(setEntityType, MRI_GPR_SUCCEEDED);
+    };
+
+    host.createChildGeoEntity = [](auto, auto, auto pEntityOut)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        ++sRecord.calls["createChildGeoEntity"];
+        *pEntityOut = _MakeHandle<typename remove_pointer<decltype(pEntityOut)>::type>(sRecord.nextHandle++);
+        return HOST_RESULT(createChildGeoEntity, MRI_GPR_SUCCEEDED);
+    };
+
+    host.setEntityName = [](auto, auto)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        ++sRecord.calls["setEntityName"];
+        return HOST_RESULT(setEntityName, MRI_GPR_SUCCEEDED);
+    };
+
+    host.getAttribute = [](auto, auto pName, auto pValue)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        string name = pName;
+        auto s = sRecord.stringAttributes.find(name);
+        if (s != sRecord.stringAttributes.end())
+        {
+            pValue->m_Type = MRI_ATTR_STRING;
+            pValue->m_pString = s->second.c_str();
+            return HOST_RESULT(getAttribute, MRI_UPR_SUCCEEDED);
+        }
+        auto i = sRecord.intAttributes.find(name);
+        if (i != sRecord.intAttributes.end())
+        {
+            pValue->m_Type = MRI_ATTR_BOOL;
+            pValue->m_Int = i->second;
+            return HOST_RESULT(getAttribute, MRI_UPR_SUCCEEDED);
+        }
+        // Anything other than MRI_UPR_SUCCEEDED reports a missing attribute.
+        return HOST_RESULT(getAttribute, MRI_UPR_SUCCEEDED + 1);
+    };
+
+    host.setAttribute = [](auto, auto pName, auto pValue)
+    {
+        lock_guard<mutex> lock(sRecordMutex);
+        ++sRecord.calls["setAttribute"];
+        if (pValue->m_Type == MRI_ATTR_STRING || pValue->m_Type == MRI_ATTR_STRING_LIST)
+            sRecord.writtenAttributes[pName] = pValue->m_pString ? pValue->m_pString : "";
+        else
+            sRecord.writtenAttributes[pName] = TfStringify(pValue->m_Int);
+        return HOST_RESULT(setAttribute, MRI_UPR_SUCCEEDED);
+    };
+
+    return host;
+}
+
+//------------------------------------------------------------------------------
+// Reporting
+//------------------------------------------------------------------------------
+
+string _FormatBytes(size_t bytes)
+{
+    const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = double(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 4)
+    {
+        value /= 1024.0;
+        ++unit;
+    }
+    return TfStringPrintf("%.2f %s", value, units[unit]);
+}
+
+double _Median(vector<double> values)
+{
+    sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    BenchOptions opts;
+    if (!_ParseArgs(argc, argv, opts))
+        return 1;
+
+    string fileName = opts.keepFile;
+    if (fileName.empty())
+    {
+        fileName = (filesystem::temp_directory_path() /
+                    TfStringPrintf("usdImportBench_%d.%s",
+#if defined(_WIN32)
+                                   int(GetCurrentProcessId()),
+#else
+                                   int(getpid()),
+#endif
+                                   opts.format.c_str())).string();
+    }
+
+    printf("usdImportBench\n");
+    printf("  gprims %d, faces/mesh %d, poly %s, uv %s, normals %s, depth %d, "
+           "instances %d, copies %d, frames %d, subdiv %d, format %s\n",
+           opts.gprims, opts.faces, opts.polyMix.c_str(), opts.uvInterpolation.c_str(),
+           opts.normalInterpolation.c_str(), opts.depth, opts.prototypes, opts.copies, opts.frames,
+           int(opts.subdiv), opts.format.c_str());
+
+    // Generate
+    Clock::time_point start = Clock::now();
+    _GenerateStage(opts, fileName);
+    double generateMs = _MillisecondsSince(start);
+    size_t fileSize = filesystem::file_size(fileName);
+    printf("  generated %s (%s) in %.1f ms\n", fileName.c_str(), _FormatBytes(fileSize).c_str(), generateMs);
+
+    MriGeoReaderHost host = _MakeRecordingHost();
+    sRecord.copyBuffers = opts.copyBuffers;
+    MriGeoEntityHandle entity = _MakeHandle<MriGeoEntityHandle>(sRecord.nextHandle++);
+    MriUserItemHandle settings = _MakeHandle<MriUserItemHandle>(sRecord.nextHandle++);
+
+    // GetSettings, as Mari does when the import dialog opens
+    start = Clock::now();
+    {
+        UsdReader reader(fileName.c_str(), host);
+        reader.GetSettings(settings);
+    }
+    double settingsMs = _MillisecondsSince(start);
+
+    // Import options - pick the first UV set offered by GetSettings
+    string uvChoices = sRecord.writtenAttributes["UV Set"];
+    sRecord.stringAttributes["UV Set"] = uvChoices.substr(0, uvChoices.find('\n'));
+    sRecord.stringAttributes["Load"] = "All Models";
+    sRecord.stringAttributes["Merge Type"] = "Merge Models";
+    sRecord.stringAttributes["Model Names"] = "";
+    sRecord.stringAttributes["Mapping Scheme"] = "UV if available, Ptex otherwise";
+    sRecord.stringAttributes["Frame Numbers"] = opts.frames > 1 ? TfStringPrintf("1-%d", opts.frames) : "1";
+    sRecord.stringAttributes["Gprim Names"] = "";
+    sRecord.stringAttributes["Variants"] = "";
+    sRecord.intAttributes["Conform to Mari Y as up"] = 1;
+    sRecord.intAttributes["Keep Centered"] = 0;
+    sRecord.intAttributes["Include Invisible"] = 0;
+    sRecord.intAttributes["Create Face Selection Group per mesh"] = 0;
+
+    // Load. The first iteration includes the stage open, later ones hit the
+    // reader's stage cache.
+    vector<double> loadMs, hostMs;
+    MriGeoPluginResult result = MRI_GPR_SUCCEEDED;
+    for (int iteration = 0; iteration < opts.iterations; ++iteration)
+    {
+        sRecord.Reset();
+        start = Clock::now();
+        {
+            UsdReader reader(fileName.c_str(), host);
+            result = reader.Load(entity);
+        }
+        loadMs.push_back(_MillisecondsSince(start));
+        hostMs.push_back(sRecord.hostMilliseconds);
+    }
+
+    printf("\nresult                 %s\n", result == MRI_GPR_SUCCEEDED ? "succeeded" : "FAILED");
+    printf("getSettings            %10.1f ms\n", settingsMs);
+    printf("load (first)           %10.1f ms\n", loadMs.front());
+    printf("  reader               %10.1f ms\n", loadMs.front() - hostMs.front());
+    printf("  host                 %10.1f ms\n", hostMs.front());
+    if (opts.iterations > 1)
+    {
+        vector<double> warm(loadMs.begin() + 1, loadMs.end());
+        printf("load (warm, median)    %10.1f ms\n", _Median(warm));
+        printf("load (warm, min)       %10.1f ms\n", *min_element(warm.begin(), warm.end()));
+    }
+    printf("peak RSS               %s\n", _FormatBytes(_PeakRssBytes()).c_str());
+
+    printf("\nmesh objects           %zu\n", sRecord.meshObjects);
+    printf("faces                  %zu\n", sRecord.faces);
+    printf("bytes createGeoData    %s\n", _FormatBytes(sRecord.bytesCreateGeoData).c_str());
+    printf("bytes setGeoDataForFrame %s\n", _FormatBytes(sRecord.bytesSetGeoDataForFrame).c_str());
+    printf("host calls             %zu\n", sRecord.TotalCalls());
+    for (const auto &it : sRecord.calls)
+        printf("  %-24s %zu\n", it.first.c_str(), it.second);
+
+    // The reader's own counters, as saved on the entity
+    printf("\nreader stats\n");
+    for (const auto &it : sRecord.writtenAttributes)
+    {
+        if (TfStringStartsWith(it.first, "UsdImport"))
+            printf("  %-32s %s\n", it.first.c_str() + strlen("UsdImport"), it.second.c_str());
+    }
+
+    // Concurrent loads, one reader per thread, as a batch script would do.
+    // Host calls are serialised by the recorder lock.
+    if (opts.threads > 0)
+    {
+        sRecord.Reset();
+        vector<MriGeoPluginResult> results(opts.threads, MRI_GPR_SUCCEEDED);
+        vector<thread> threads;
+        start = Clock::now();
+        for (int i = 0; i < opts.threads; ++i)
+        {
+            threads.emplace_back([&, i]()
+            {
+                UsdReader reader(fileName.c_str(), host);
+                results[i] = reader.Load(entity);
+            });
+        }
+        for (thread &t : threads)
+            t.join();
+        double concurrentMs = _MillisecondsSince(start);
+        double serialMs = opts.iterations > 1
+            ? _Median(vector<double>(loadMs.begin() + 1, loadMs.end()))
+            : loadMs.front();
+        bool succeeded = all_of(results.begin(), results.end(),
+                                [](MriGeoPluginResult r) { return r == MRI_GPR_SUCCEEDED; });
+
+        printf("\nconcurrent loads       %d (%s)\n", opts.threads, succeeded ? "succeeded" : "FAILED");
+        printf("  wall                 %10.1f ms\n", concurrentMs);
+        printf("  host                 %10.1f ms\n", sRecord.hostMilliseconds);
+        printf("  speedup vs serial    %10.2fx\n", serialMs * opts.threads / concurrentMs);
+        if (!succeeded)
+            result = MRI_GPR_FAILED;
+    }
+
+    if (opts.keepFile.empty())
+        filesystem::remove(fileName);
+
+    return result == MRI_GPR_SUCCEEDED ? 0 : 2;
+}
@@ -0,0 +1,320 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+// usdPluginStartupBench
+//
+// Measures what loading the USDImport plug-in costs Mari at startup: the
+// time to load the library, call getPlugins and setHost, and the resident
+// memory and number of shared libraries added by it. Each mode runs in a
+// fresh process:
+//   lazy     the default, USDImportImpl (and USD) are only loaded on first use
+//   preload  MARI_USD_PRELOAD=1, USDImportImpl is loaded from setHost
+// With --first-use FILE, getSettings is then called on FILE, to also measure
+// what the lazy mode defers to the first import.
+//
+// Example:
+//   usdPluginStartupBench ~/Mari/Plugins/libUSDImport.so --first-use asset.usdc
+
+#include "MriGeoReaderPlugin.h"
+#include "MariHostConfig.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#else
+#include <dlfcn.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <link.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+
+typedef chrono::steady_clock Clock;
+
+double _MillisecondsSince(Clock::time_point start)
+{
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Current resident memory, or the peak where the current one is not known
+size_t _RssBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.WorkingSetSize;
+    return 0;
+#elif defined(__linux__)
+    long pages = 0, resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+        resident = 0;
+    fclose(statm);
+    return size_t(resident) * size_t(sysconf(_SC_PAGESIZE));
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return size_t(usage.ru_maxrss);
+#endif
+}
+
+// Number of shared libraries loaded in the process, -1 if unknown
+int _LoadedLibraries()
+{
+#if defined(_WIN32)
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, GetCurrentProcessId());
+    if (snapshot == INVALID_HANDLE_VALUE)
+        return -1;
+    MODULEENTRY32 entry;
+    entry.dwSize = sizeof(entry);
+    int count = 0;
+    for (BOOL found = Module32First(snapshot, &entry); found; found = Module32Next(snapshot, &entry))
+        ++count;
+    CloseHandle(snapshot);
+    return count;
+#elif defined(__linux__)
+    int count = 0;
+    dl_iterate_phdr([](struct dl_phdr_info *, size_t, void *data)
+    {
+        ++*static_cast<int *>(data);
+        return 0;
+    }, &count);
+    return count;
+#else
+    return -1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Host stand-in, that does nothing
+//------------------------------------------------------------------------------
+
+template <typename FN>
+struct HostFnResult;
+
+template <typename R, typename... ARGS>
+struct HostFnResult<R (*)(ARGS...)>
+{
+    typedef R type;
+};
+
+#define HOST_RESULT(member, value) \
+    static_cast<HostFnResult<decltype(MriGeoReaderHost::member)>::type>(value)
+
+void _Trace(const char *, ...)
+{
+}
+
+MriGeoReaderHost sHost;
+
+const void *_GetSuite(const char *, unsigned int)
+{
+    return &sHost;
+}
+
+void _InitHost()
+{
+    memset(&sHost, 0, sizeof(sHost));
+    sHost.trace = &_Trace;
+    sHost.setAttribute = [](auto, auto, auto)
+    {
+        return HOST_RESULT(setAttribute, MRI_UPR_SUCCEEDED);
+    };
+    sHost.getAttribute = [](auto, auto, auto)
+    {
+        // Anything other than MRI_UPR_SUCCEEDED reports a missing attribute.
+        return HOST_RESULT(getAttribute, MRI_UPR_SUCCEEDED + 1);
+    };
+}
+
+//------------------------------------------------------------------------------
+
+void *_OpenLibrary(const string &path)
+{
+#if defined(_WIN32)
+    return (void *)LoadLibraryA(path.c_str());
+#else
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+void *_FindSymbol(void *library, const char *name)
+{
+#if defined(_WIN32)
+    return (void *)GetProcAddress((HMODULE)library, name);
+#else
+    return dlsym(library, name);
+#endif
+}
+
+// Loads the plug-in as Mari does, in this process
+int _RunMode(const string &mode, const string &pluginPath, const string &firstUseFile)
+{
+    if (mode == "preload")
+    {
+#if defined(_WIN32)
+        _putenv_s("MARI_USD_PRELOAD", "1");
+#else
+        setenv("MARI_USD_PRELOAD", "1", 1);
+#endif
+    }
+    _InitHost();
+
+    const size_t rssBefore = _RssBytes();
+    const int librariesBefore = _LoadedLibraries();
+
+    Clock::time_point start = Clock::now();
+    void *library = _OpenLibrary(pluginPath);
+    if (!library)
+    {
+        fprintf(stderr, "Cannot load %s\n", pluginPath.c_str());
+        return 1;
+    }
+    const double openMs = _MillisecondsSince(start);
+
+    typedef FnPlugin *(*GetPluginsFn)(unsigned int *);
+    GetPluginsFn getPlugins = (GetPluginsFn)_FindSymbol(library, "getPlugins");
+    if (!getPlugins)
+    {
+        fprintf(stderr, "%s has no getPlugins\n", pluginPath.c_str());
+        return 1;
+    }
+
+    FnPluginHost pluginHost;
+    memset(&pluginHost, 0, sizeof(pluginHost));
+    pluginHost.name = "usdPluginStartupBench";
+    pluginHost.versionStr = "0";
+    pluginHost.getSuite = &_GetSuite;
+
+    unsigned int numPlugins = 0;
+    FnPlugin *plugin = getPlugins(&numPlugins);
+    if (numPlugins == 0 || plugin->setHost(&pluginHost) != FnPluginStatusOK)
+    {
+        fprintf(stderr, "Cannot connect %s\n", pluginPath.c_str());
+        return 1;
+    }
+    const double startupMs = _MillisecondsSince(start);
+
+    printf("%-8s startup %8.1f ms (library load %.1f ms), RSS +%.1f MiB, libraries +%d\n",
+           mode.c_str(), startupMs, openMs,
+           (double(_RssBytes()) - double(rssBefore)) / (1024.0 * 1024.0),
+           _LoadedLibraries() - librariesBefore);
+
+    if (!firstUseFile.empty())
+    {
+        const MriGeoReaderPluginV1 *suite = (const MriGeoReaderPluginV1 *)plugin->getSuite();
+        int dummyHandle = 0;
+        start = Clock::now();
+        MriGeoPluginResult result = suite->getSettings((MriUserItemHandle)&dummyHandle, firstUseFile.c_str());
+        printf("%-8s first getSettings %8.1f ms (%s), RSS +%.1f MiB, libraries +%d\n",
+               mode.c_str(), _MillisecondsSince(start),
+               result == MRI_GPR_SUCCEEDED ? "succeeded" : "FAILED",
+               (double(_RssBytes()) - double(rssBefore)) / (1024.0 * 1024.0),
+               _LoadedLibraries() - librariesBefore);
+    }
+
+    plugin->flush();
+    return 0;
+}
+
+void _Usage()
+{
+    fprintf(stderr,
+        "usage: usdPluginStartupBench PLUGIN [options]\n"
+        "  PLUGIN               path to the USDImport plug-in library\n"
+        "  --mode lazy|preload  run one mode in this process (default: run both, each in a new process)\n"
+        "  --first-use FILE     then call getSettings on FILE\n");
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char **argv)
+{
+    string pluginPath, mode, firstUseFile;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--mode" && hasValue)                mode = argv[++i];
+        else if (arg == "--first-use" && hasValue)      firstUseFile = argv[++i];
+        else if (pluginPath.empty() && arg[0] != '-')   pluginPath = arg;
+        else
+        {
+            _Usage();
+            return 1;
+        }
+    }
+
+    if (pluginPath.empty())
+    {
+        _Usage();
+        return 1;
+    }
+
+    if (!mode.empty())
+        return _RunMode(mode, pluginPath, firstUseFile);
+
+    // Each mode in a fresh process, so that neither sees the other's libraries
+    printf("usdPluginStartupBench %s\n", pluginPath.c_str());
+    int result = 0;
+    for (const char *childMode : {"lazy", "preload"})
+    {
+        fflush(stdout);
+        string command = "\"" + string(argv[0]) + "\" \"" + pluginPath + "\" --mode " + childMode;
+        if (!firstUseFile.empty())
+            command += " --first-use \"" + firstUseFile + "\"";
+#if defined(_WIN32)
+        // cmd.exe strips the outer quotes of the command line
+        command = "\"" + command + "\"";
+#endif
+        if (system(command.c_str()) != 0)
+            result = 1;
+    }
+    return result;
+}
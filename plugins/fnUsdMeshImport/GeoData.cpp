@@ -29,16 +29,24 @@
 //
 
 #include "GeoData.h"
+#include "GeoDataKernels.h"
 #include "pxr/base/gf/vec3d.h"
 #include "pxr/base/gf/vec2f.h"
 
 #include "pxr/base/vt/value.h"
 #include "pxr/base/vt/array.h"
 #include "pxr/base/tf/envSetting.h"
+#include "pxr/base/tf/staticTokens.h"
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/trace/trace.h"
+#include "pxr/base/work/loops.h"
+#include "pxr/base/work/sort.h"
 #include "pxr/usd/usdGeom/mesh.h"
 #include "pxr/usd/usdGeom/xformCache.h"
 #include "pxr/usd/usdGeom/primvarsAPI.h"
 
+#include <algorithm>
+#include <numeric>
 #include <float.h>
 using namespace std;
 PXR_NAMESPACE_USING_DIRECTIVE
@@ -46,15 +54,148 @@ PXR_NAMESPACE_USING_DIRECTIVE
 TF_DEFINE_ENV_SETTING(MARI_READ_FLOAT2_AS_UV, true,
         "Set to false to disable ability to read Float2 type as a UV set");
 
-std::vector<std::string> GeoData::_requireGeomPathSubstring;
-std::vector<std::string> GeoData::_ignoreGeomPathSubstring;
+TF_DEFINE_PRIVATE_TOKENS(
+    _tokens,
+    ((primvarsPrefix, "primvars:"))
+    ((uPrefix, "u_"))
+    ((vPrefix, "v_"))
+);
 
-std::string GeoData::_requireGeomPathSubstringEnvVar = "PX_USDREADER_REQUIRE_GEOM_PATH_SUBSTR";
-std::string GeoData::_ignoreGeomPathSubstringEnvVar = "PX_USDREADER_IGNORE_GEOM_PATH_SUBSTR";
+static const char *_requireGeomPathSubstringEnvVar = "PX_USDREADER_REQUIRE_GEOM_PATH_SUBSTR";
+static const char *_ignoreGeomPathSubstringEnvVar = "PX_USDREADER_IGNORE_GEOM_PATH_SUBSTR";
+
+// Index arrays are fingerprinted in blocks of this many entries
+static const size_t _fingerprintBlockSize = 1 << 16;
+// and their faces marked on the UDIM tiles in blocks of this many faces
+static const size_t _udimBlockSize = 1 << 16;
 
 //#define PRINT_DEBUG
 //#define PRINT_ARRAYS
 
+//------------------------------------------------------------------------------
+// Primvar expansion
+//------------------------------------------------------------------------------
+
+static bool _GetInterpolation(const TfToken &token, GeoDataKernels::Interpolation &interpolation)
+{
+    using GeoDataKernels::Interpolation;
+    if (token == UsdGeomTokens->constant)
+        interpolation = Interpolation::Constant;
+    else if (token == UsdGeomTokens->uniform)
+        interpolation = Interpolation::Uniform;
+    else if (token == UsdGeomTokens->vertex)
+        interpolation = Interpolation::Vertex;
+    else if (token == UsdGeomTokens->varying)
+        interpolation = Interpolation::Varying;
+    else if (token == UsdGeomTokens->faceVarying)
+        interpolation = Interpolation::FaceVarying;
+    else
+        return false;
+    return true;
+}
+
+// Number of elements a primvar with this interpolation has on the mesh
+static size_t _GetNumElements(GeoDataKernels::Interpolation interpolation,
+                              const std::vector<int> &faceCounts,
+                              const std::vector<int> &vertexIndices,
+                              int maxVertexIndex)
+{
+    using GeoDataKernels::Interpolation;
+    switch (interpolation)
+    {
+        case Interpolation::Constant:    return 1;
+        case Interpolation::Uniform:     return faceCounts.size();
+        case Interpolation::Vertex:
+        case Interpolation::Varying:     return size_t(maxVertexIndex) + 1;
+        case Interpolation::FaceVarying: return vertexIndices.size();
+    }
+    return 0;
+}
+
+template <GeoDataKernels::Interpolation I, int Arity = 0>
+static void _ExpandIndices(const std::vector<int> &faceCounts,
+                           const std::vector<int> &vertexIndices,
+                           const VtIntArray &indices,
+                           std::vector<int> &faceVaryingIndices)
+{
+    faceVaryingIndices.resize(vertexIndices.size());
+    if (indices.empty())
+    {
+        GeoDataKernels::ExpandToFaceVarying<I, false, Arity>(faceCounts.data(), faceCounts.size(),
+                                                      vertexIndices.data(), vertexIndices.size(),
+                                                      nullptr, faceVaryingIndices.data());
+    }
+    else
+    {
+        GeoDataKernels::ExpandToFaceVarying<I, true, Arity>(faceCounts.data(), faceCounts.size(),
+                                                     vertexIndices.data(), vertexIndices.size(),
+                                                     indices.cdata(), faceVaryingIndices.data());
+    }
+}
+
+// Expands a primvar of float tuples (GfVec2f, GfVec3f...), indexed or not,
+// into the flat values and the face varying index table the host takes.
+// Every primvar handed to Mari goes through here. Returns false, leaving
+// the outputs untouched, if the primvar does not fit the mesh's topology.
+// faceArity is the number of vertices of every face, 0 if they differ:
+// all-triangle and all-quad meshes take fixed arity loops.
+template <typename T>
+static bool _ExpandPrimvar(const VtArray<T> &values,
+                           const VtIntArray &indices,
+                           GeoDataKernels::Interpolation interpolation,
+                           const std::vector<int> &faceCounts,
+                           const std::vector<int> &vertexIndices,
+                           int faceArity,
+                           int maxVertexIndex,
+                           std::vector<float> &flatValues,
+                           std::vector<int> &faceVaryingIndices)
+{
+    using GeoDataKernels::Interpolation;
+
+    const size_t numElements = _GetNumElements(interpolation, faceCounts, vertexIndices, maxVertexIndex);
+    if (indices.empty() ? values.size() < numElements
+                        : (indices.size() < numElements ||
+                           !GeoDataKernels::IndicesInRange(indices.cdata(), numElements, values.size())))
+    {
+        return false;
+    }
+    if (interpolation == Interpolation::Uniform &&
+        (faceArity > 0 ? faceCounts.size() * size_t(faceArity)
+                       : GeoDataKernels::Sum(faceCounts.data(), faceCounts.size())) != vertexIndices.size())
+    {
+        return false;
+    }
+
+    switch (interpolation)
+    {
+        case Interpolation::Constant:
+            _ExpandIndices<Interpolation::Constant>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            break;
+        case Interpolation::Uniform:
+            if (faceArity == 3)
+                _ExpandIndices<Interpolation::Uniform, 3>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            else if (faceArity == 4)
+                _ExpandIndices<Interpolation::Uniform, 4>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            else
+                _ExpandIndices<Interpolation::Uniform>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            break;
+        case Interpolation::Vertex:
+            _ExpandIndices<Interpolation::Vertex>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            break;
+        case Interpolation::Varying:
+            _ExpandIndices<Interpolation::Varying>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            break;
+        case Interpolation::FaceVarying:
+            _ExpandIndices<Interpolation::FaceVarying>(faceCounts, vertexIndices, indices, faceVaryingIndices);
+            break;
+    }
+
+    constexpr size_t N = sizeof(T) / sizeof(float);
+    flatValues.resize(values.size() * N);
+    GeoDataKernels::FlattenTuples<N>(values.cdata(), values.size(), flatValues.data());
+    return true;
+}
+
 //------------------------------------------------------------------------------
 // GeoData implementation
 //------------------------------------------------------------------------------
@@ -68,15 +209,21 @@ bool GeoData::ReadFloat2AsUV()
 
 GeoData::GeoData(UsdPrim const &prim,
                  std::string uvSet,
+                 const std::vector<std::string> &additionalUvSets,
                  std::string mappingScheme,
+                 bool generateNormals,
+                 bool cleanUp,
+                 bool reorderForPainting,
                  std::vector<int> frames,
                  bool conformToMariY,
                  bool readerIsUpY,
                  bool keepCentered,
                  UsdPrim const &model,
                  const MriGeoReaderHost& host,
-                 std::vector<std::string>& log)
+                 ImportLog& log)
 {
+    TRACE_FUNCTION();
+
     // Init
     m_isSubdivMesh = false;
     m_subdivisionScheme = "";
@@ -88,8 +235,8 @@ GeoData::GeoData(UsdPrim const &prim,
     UsdGeomMesh mesh(prim);
     if (not mesh)
     {
-        host.trace("[GeoData:%d] Invalid non-mesh prim %s (type %s)", __LINE__, prim.GetPath().GetText(), prim.GetTypeName().GetText());
-        log.push_back("** Invalid non-mesh prim " + std::string(prim.GetPath().GetText()) + " of type " + std::string(prim.GetTypeName().GetText()));
+        MARI_USD_LOG_WARNING(log, "** Invalid non-mesh prim %s of type %s", prim.GetPath().GetText(), prim.GetTypeName().GetText());
+        m_rejectReason = "not a mesh";
         return;
     }
 
@@ -101,12 +248,13 @@ GeoData::GeoData(UsdPrim const &prim,
 #endif
     // Read vertex/face indices
     {
+        TRACE_SCOPE("GeoData: read face vertex indices");
         VtIntArray vertsIndicesArray;
         bool ok = isTopologyVarying ? mesh.GetFaceVertexIndicesAttr().Get(&vertsIndicesArray, UsdTimeCode::EarliestTime()) : mesh.GetFaceVertexIndicesAttr().Get(&vertsIndicesArray);
         if (!ok)
         {
-            host.trace("[GeoData:%d]\tfailed getting face vertex indices on %s.", __LINE__, prim.GetPath().GetText());
-            log.push_back("** Failed getting faces on " + std::string(prim.GetPath().GetText()));
+            MARI_USD_LOG_WARNING(log, "** Failed getting faces on %s", prim.GetPath().GetText());
+            m_rejectReason = "cannot read face vertex indices";
             return;// this is not optional!
         }
         m_vertexIndices = vector<int>(vertsIndicesArray.begin(), vertsIndicesArray.end());
@@ -114,30 +262,33 @@ GeoData::GeoData(UsdPrim const &prim,
 
     // Read face counts
     {
+        TRACE_SCOPE("GeoData: read face vertex counts");
         VtIntArray nvertsPerFaceArray;
         bool ok = isTopologyVarying ? mesh.GetFaceVertexCountsAttr().Get(&nvertsPerFaceArray, UsdTimeCode::EarliestTime()) : mesh.GetFaceVertexCountsAttr().Get(&nvertsPerFaceArray);
         if (!ok)
         {
-            host.trace("[GeoData:%d]\tfailed getting face counts on %s", __LINE__, prim.GetPath().GetText());
-            log.push_back("** Failed getting faces on " + std::string(prim.GetPath().GetText()));
+            MARI_USD_LOG_WARNING(log, "** Failed getting faces on %s", prim.GetPath().GetText());
+            m_rejectReason = "cannot read face vertex counts";
             return;// this is not optional!
         }
         m_faceCounts = vector<int>(nvertsPerFaceArray.begin(), nvertsPerFaceArray.end());
+        m_faceArity = GeoDataKernels::UniformFaceArity(m_faceCounts.data(), m_faceCounts.size());
     }
 
     // Create face selection indices
     {
-        m_faceSelectionIndices.reserve(m_faceCounts.size());
-        for(int x = 0; x < m_faceCounts.size(); ++x)
-        {
-            m_faceSelectionIndices.push_back(x);
-        }
+        m_faceSelectionIndices.resize(m_faceCounts.size());
+        GeoDataKernels::Iota(m_faceSelectionIndices.data(), m_faceSelectionIndices.size());
     }
 
+    // Vertex interpolated primvars have one element per point used
+    const int maxVertexIndex = GeoDataKernels::MaxIndex(m_vertexIndices.data(), m_vertexIndices.size());
+
     UsdGeomPrimvarsAPI meshPrimApi(mesh);
 
     if (mappingScheme != "Force Ptex")
     {
+        TRACE_SCOPE("GeoData: read uvs");
         if ((mappingScheme == "Force empty") || // Force all UVs to be zero or...
             (uvSet.empty() && mappingScheme == "UV if available, empty otherwise")) // ...allowing empty UVs and it has none.
         {
@@ -146,95 +297,34 @@ GeoData::GeoData(UsdPrim const &prim,
             m_uvs[0] = 0.0f;
             m_uvs[1] = 0.0f;
             
-            m_uvIndices = std::vector<int>(m_vertexIndices.size(), 0);
+            _ExpandIndices<GeoDataKernels::Interpolation::Constant>(m_faceCounts, m_vertexIndices, VtIntArray(), m_uvIndices);
         }
         else if (!uvSet.empty())
         {
-            // Get UV set primvar
-            if (UsdGeomPrimvar uvPrimvar = meshPrimApi.GetPrimvar(TfToken(uvSet)))
+            // VITAL NOTE: the final uv indices array count MUST MATCH the vertex indices array count
+            switch (_ReadUvSet(prim, uvSet, isTopologyVarying, maxVertexIndex, m_uvs, m_uvIndices))
             {
-                SdfValueTypeName typeName      = uvPrimvar.GetTypeName();
-                TfToken          interpolation = uvPrimvar.GetInterpolation();
-
-                if ((interpolation == UsdGeomTokens->faceVarying or interpolation == UsdGeomTokens->vertex) and (typeName == SdfValueTypeNames->TexCoord2fArray or (GeoData::ReadFloat2AsUV() and typeName == SdfValueTypeNames->Float2Array)))
-                {
-                    VtVec2fArray values;
-                    VtIntArray indices;
-                    if (uvPrimvar.Get(&values, UsdTimeCode::EarliestTime()))
-                    {
-                        // Read uvs
-                        m_uvs.resize(values.size()*2);
-                        for (int i = 0; i < values.size(); ++i)
-                        {
-                            m_uvs[i * 2    ] = values[i][0];
-                            m_uvs[i * 2 + 1] = values[i][1];
-                        }
-
-                        // Get indices
-                        bool ok = isTopologyVarying ? uvPrimvar.GetIndices(&indices, UsdTimeCode::EarliestTime()) : uvPrimvar.GetIndices(&indices);
-                        if (ok)
-                        {
-                            if (interpolation == UsdGeomTokens->faceVarying)
-                            {
-                                // All good -> primvar is indexed: validate/process values and indices together
-                                m_uvIndices = vector<int>(indices.begin(), indices.end());
-                            }
-                            else
-                            {
-                                // vertex interpolated -> do extra extrapolation
-                                m_uvIndices.reserve(m_vertexIndices.size());
-
-                                // To build an actual face varying uv indices array, we need to
-                                // 1. for each vertex V on a face F, get its vertex index V from the vertexIndices array
-                                // 2. use VI as an index into the original vertex-interpolcated uv index table, to get uv index UVI
-                                // 3. add UVI to final face varying uv index array
-                                // VITAL NOTE: the final uv indices array count MUST MATCH the vertex indices array count
-                                std::vector<int> UvIndices = vector<int>(indices.begin(), indices.end());
-                                int globalIndex = 0;
-                                for(int x = 0; x < m_faceCounts.size(); ++x)
-                                {
-                                    int vertCount = m_faceCounts[x];
-                                    for (int vertIndex = 0; vertIndex < vertCount; ++vertIndex)
-                                    {
-                                        int vertId = m_vertexIndices[globalIndex++];
-
-                                        int uvId = UvIndices[vertId];
-                                        m_uvIndices.push_back(uvId);
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            // Our uvs are not indexed -> we need to fill in an ordered list of indices
-                            m_uvIndices.reserve(m_vertexIndices.size());
-                            for (unsigned int x = 0; x < m_vertexIndices.size(); ++x)
-                            {
-                                m_uvIndices.push_back(x);
-                            }
-                        }
-                    }
-                    else
-                    {
-                        // Could not read uvs
-                        host.trace("[GeoData:%d]\tDiscarding mesh %s - specified uv set %s cannot be read", __LINE__, prim.GetPath().GetText(), uvSet.c_str());
-                        log.push_back("** Discarding mesh " + std::string(prim.GetPath().GetText()) + " - specified uv set " + uvSet + " cannot be read");
-                        return;
-                    }
-                }
-                else
-                {
-                    // Incorrect interpolation
-                    host.trace("[GeoData:%d]\tDiscarding mesh %s - specified uv set %s is not of type 'faceVarying or vertex'", __LINE__, prim.GetPath().GetText(), uvSet.c_str());
-                    log.push_back("** Discarding mesh " + std::string(prim.GetPath().GetText()) + " - specified uv set " + uvSet + " is not of type 'faceVarying or vertex'");
+                case UvSetStatus::Read:
+                    break;
+                case UvSetStatus::NotFound:
+                    // UV set not found on mesh
+                    MARI_USD_LOG_WARNING(log, "** Specified uv set %s not found on mesh %s - will use ptex", uvSet.c_str(), prim.GetPath().GetText());
+                    log.Count("meshes without the requested uv set, using ptex", uvSet);
+                    break;
+                case UvSetStatus::Unsupported:
+                    // Incorrect type or interpolation
+                    MARI_USD_LOG_WARNING(log, "** Discarding mesh %s - specified uv set %s is not a texCoord2f primvar or u_/v_ float pair with a known interpolation", prim.GetPath().GetText(), uvSet.c_str());
+                    m_rejectReason = "unsupported uv set interpolation";
+                    return;
+                case UvSetStatus::Unreadable:
+                    // Could not read uvs
+                    MARI_USD_LOG_WARNING(log, "** Discarding mesh %s - specified uv set %s cannot be read", prim.GetPath().GetText(), uvSet.c_str());
+                    m_rejectReason = "uv set cannot be read";
+                    return;
+                case UvSetStatus::Mismatch:
+                    MARI_USD_LOG_WARNING(log, "** Discarding mesh %s - specified uv set %s does not match its topology", prim.GetPath().GetText(), uvSet.c_str());
+                    m_rejectReason = "uv set does not match the topology";
                     return;
-                }
-            }
-            else
-            {
-                // UV set not found on mesh
-                host.trace("[GeoData:%d]\tSpecified uv set %s not found on mesh %s - will use ptex", __LINE__, uvSet.c_str(), prim.GetPath().GetText());
-                log.push_back("** Discarding mesh " + std::string(prim.GetPath().GetText()) + " - specified uv set " + uvSet + " not found");
             }
         }
     }
@@ -243,8 +333,32 @@ GeoData::GeoData(UsdPrim const &prim,
         // Mari will use Ptex for uv-ing later on
     }
 
+    // Additional uv sets, in the same pass. A set that cannot be imported is
+    // left out, the mesh is not discarded for it.
+    for (const std::string &name : additionalUvSets)
+    {
+        TRACE_SCOPE("GeoData: read additional uvs");
+        AdditionalUvSet additional;
+        additional.name = name;
+        const UvSetStatus status = _ReadUvSet(prim, name, isTopologyVarying, maxVertexIndex, additional.uvs, additional.indices);
+        if (status == UvSetStatus::Read)
+        {
+            _ShareUvIndices(additional);
+            m_additionalUvSets.push_back(std::move(additional));
+        }
+        else if (status != UvSetStatus::NotFound)
+        {
+            const char *reason = status == UvSetStatus::Unsupported ? "unsupported uv set interpolation"
+                               : status == UvSetStatus::Unreadable ? "uv set cannot be read"
+                               : "uv set does not match the topology";
+            MARI_USD_LOG_WARNING(log, "** Ignoring additional uv set %s on mesh %s - %s", name.c_str(), prim.GetPath().GetText(), reason);
+            log.Count("additional uv sets ignored", reason);
+        }
+    }
+
     // Read normals
     {
+        TRACE_SCOPE("GeoData: read normals");
         VtVec3fArray normalsVt;
         VtIntArray indices;
         TfToken interpolation;
@@ -271,158 +385,44 @@ GeoData::GeoData(UsdPrim const &prim,
             interpolation = mesh.GetNormalsInterpolation();
         }
 
-        if (ok)
+        GeoDataKernels::Interpolation normalsInterpolation;
+        if (ok && _GetInterpolation(interpolation, normalsInterpolation))
         {
-            if ((interpolation == UsdGeomTokens->faceVarying) || (interpolation == UsdGeomTokens->vertex))
-            {
-                const size_t numNormals = normalsVt.size();
-
-                // Generate a list of indices to use if an explicit list was not specified.
-                if (indices.empty())
-                {
-                    // TP-524982 - Slightly convoluted but some files have as many vertex normals as there are vertices
-                    //             and some have as many as there are vertex indices. When mapping normals to vertices
-                    //             in a 1:1 fashion, we need to make sure they match up.
-
-                    // First we find out what the maximum vertex index is.
-                    // Note: This is not the same as the number of indices.
-                    int maxVertexIndex = 0;
-                    for (const int &vertexIndex : m_vertexIndices)
-                    {
-                        if (vertexIndex > maxVertexIndex)
-                            maxVertexIndex = vertexIndex;
-                    }
-
-                    const int numVertIndices = static_cast<int>(m_vertexIndices.size());
-
-                    indices.reserve(numVertIndices);
-
-                    if (numNormals == maxVertexIndex+1)
-                    {
-                        // In the case where there are as many normals as there are vertices
-                        // we'll match up the normal indices to the vertex indices.
-                        for (int x = 0; x < numVertIndices; ++x)
-                        {
-                            indices.push_back(m_vertexIndices[x]);
-                        }
-                    }
-                    else
-                    {
-                        // In the case where there are as many normals as there are vertex
-                        // indices, we'll just use a linear list.
-                        for (int x = 0; x < numVertIndices; ++x)
-                        {
-                            indices.push_back(x);
-                        }
-                    }
-                }
-
-                // Extract the normal vectors.
-                m_normals.reserve(numNormals * 3);
-                for (const GfVec3f& normal : normalsVt)
-                {
-                    m_normals.push_back(normal[0]);
-                    m_normals.push_back(normal[1]);
-                    m_normals.push_back(normal[2]);
-                }
+            using GeoDataKernels::Interpolation;
+            const size_t numNormals = normalsVt.size();
 
-                // Handle the normal indices.
-                if (interpolation == UsdGeomTokens->faceVarying)
+            // TP-524982 - Slightly convoluted but some files have as many vertex normals as there are vertices
+            //             and some have as many as there are vertex indices, whichever of the two they claim.
+            //             Without indices, the count tells which one it is.
+            if (indices.empty() && (normalsInterpolation == Interpolation::Vertex || normalsInterpolation == Interpolation::FaceVarying))
+            {
+                if (numNormals == size_t(maxVertexIndex) + 1)
                 {
-                    // For face varying, we can take the index list as-is.
-                    m_normalIndices = vector<int>(indices.begin(), indices.end());
+                    normalsInterpolation = Interpolation::Vertex;
                 }
-                else if (interpolation == UsdGeomTokens->vertex)
+                else if (numNormals == m_vertexIndices.size())
                 {
-                    // For vertex interpolated, handle it in the same manner as the UVs above.
-                    m_normalIndices.reserve(m_vertexIndices.size());
-
-                    int globalIndex = 0;
-                    for (const int vertCount : m_faceCounts)
-                    {
-                        for (int vertIndex = 0; vertIndex < vertCount; ++vertIndex)
-                        {
-                            const int vertId = m_vertexIndices[globalIndex++];
-
-                            const int uvId = indices[vertId];
-                            m_normalIndices.push_back(uvId);
-                        }
-                    }
+                    normalsInterpolation = Interpolation::FaceVarying;
                 }
             }
-            else
-            {
-                // UV set not found on mesh
-                host.trace("[GeoData:%d]\tVertex normals for mesh %s are not interpolated as 'vertex' or 'faceVarying', ignoring them.", __LINE__, prim.GetPath().GetText());
-                log.push_back("** Vertex normals for mesh " + std::string(prim.GetPath().GetText()) + " are not interpolated as 'vertex' or 'faceVarying', ignoring them.");
-            }
-        }
-    }
-
-    // Load vertices and animation frames
-    GfMatrix4d const IDENTITY(1);
-    vector<float> points;
-    for (unsigned int iFrame = 0; iFrame < frames.size(); ++iFrame) 
-    {
-        // Get frame sample corresponding to frame index
-        unsigned int frameSample = frames[iFrame];
-        double currentTime = double(frameSample);
-
-        // Read points for this frame sample
-        VtVec3fArray pointsVt;
-        if (!mesh.GetPointsAttr().Get(&pointsVt, frameSample))
-        {
-            host.trace("[GeoData:%d]\tfailed getting vertices on %s.", __LINE__, prim.GetPath().GetName().c_str());
-            log.push_back("** Failed getting faces on " + prim.GetPath().GetName());
-            return;// this is not optional!
-        }
-        
-        points.resize(pointsVt.size() * 3);
-        for(int i = 0; i < pointsVt.size(); ++i) 
-        {
-            points[i * 3    ] = pointsVt[i][0];
-            points[i * 3 + 1] = pointsVt[i][1];
-            points[i * 3 + 2] = pointsVt[i][2];
-        }
-
-        // Calculate transforms - if not identity, pre-transform all points in place
-        UsdGeomXformCache xformCache(currentTime);
-        GfMatrix4d fullXform = xformCache.GetLocalToWorldTransform(prim);
 
-        if (keepCentered)
-        {
-            // ignore transforms up to the model level
-            GfMatrix4d m = xformCache.GetLocalToWorldTransform(model);
-            fullXform = fullXform * m.GetInverse();
-        }
-        if (fullXform != IDENTITY)
-        {
-            unsigned int psize = points.size();
-            for (unsigned int iPoint = 0; iPoint < psize; iPoint += 3)
+            if (!_ExpandPrimvar(normalsVt, indices, normalsInterpolation, m_faceCounts, m_vertexIndices, m_faceArity, maxVertexIndex, m_normals, m_normalIndices))
             {
-                GfVec4d p(points[iPoint], points[iPoint + 1], points[iPoint + 2], 1.0);
-                p = p * fullXform;
-                points[iPoint    ] = p[0];
-                points[iPoint + 1] = p[1];
-                points[iPoint + 2] = p[2];
+                MARI_USD_LOG_WARNING(log, "** Vertex normals for mesh %s do not match its topology, ignoring them.", prim.GetPath().GetText());
+                log.Count("meshes with normals ignored", "normals do not match the topology");
             }
         }
-
-        if (conformToMariY && !readerIsUpY)
+        else if (ok)
         {
-            // Our source is Z and we need to conform to Y -> let's flip
-            unsigned int psize = points.size();
-            for (unsigned int iPoint = 0; iPoint < psize; iPoint += 3)
-            {
-                float y = points[iPoint + 1];
-                points[iPoint + 1] = points[iPoint + 2];
-                points[iPoint + 2] = -y;
-            }
+            MARI_USD_LOG_WARNING(log, "** Vertex normals for mesh %s have an unknown interpolation %s, ignoring them.", prim.GetPath().GetText(), interpolation.GetText());
+            log.Count("meshes with normals ignored", "unknown interpolation");
         }
+    }
 
-        // Insert transformed vertices in our map
-        m_vertices[frameSample].resize(points.size());
-        m_vertices[frameSample] = points;
+    // Load vertices and animation frames
+    if (!_ReadPoints(prim, frames, conformToMariY, readerIsUpY, keepCentered, model, log))
+    {
+        return;// this is not optional!
     }
 
     // DEBUG
@@ -490,6 +490,7 @@ GeoData::GeoData(UsdPrim const &prim,
 
     // Read OpenSubdiv structures
     {
+        TRACE_SCOPE("GeoData: read subdiv tags");
         VtIntArray creaseIndicesArray;
         if (mesh.GetCreaseIndicesAttr().Get(&creaseIndicesArray))
         {
@@ -617,172 +618,1657 @@ GeoData::GeoData(UsdPrim const &prim,
             }
         }
     }
-}
-
-GeoData::~GeoData()
-{
-    Reset();
-}
-
-
-// Print the internal status of the Geometric Data.
-void GeoData::Log(const MriGeoReaderHost& host)
-{
-}
-
-// Cast to bool. False if no good data is found.
-GeoData::operator bool()
-{
-    return (m_vertices.size() > 0 && m_vertices.begin()->second.size()>0 && m_vertexIndices.size()>0);
-}
-
-// Static - Sanity test to see if the usd prim is something we can use.
-bool GeoData::IsValidNode(UsdPrim const &prim)
-{
-    if (not prim.IsA<UsdGeomMesh>())
-        return false;
-    else
-        return TestPath( prim.GetPath().GetText());
-}
-
-
-
-// Pre-scan the UsdStage to see what uv sets are included.
-void GeoData::GetUvSets(UsdPrim const &prim, UVSet &retval)
-{
-    UsdGeomGprim   gprim(prim);
-    if (not gprim)
-        return;
-
-    UsdGeomPrimvarsAPI gPrimApi(gprim);
 
-    vector<UsdGeomPrimvar> primvars = gPrimApi.GetPrimvars();
-    TF_FOR_ALL(primvar, primvars) 
+    if (cleanUp && !m_vertexIndices.empty() && !m_vertices.empty())
     {
-        TfToken          name, interpolation;
-        SdfValueTypeName typeName;
-        int              elementSize;
+        _CleanUp(prim, log);
+    }
 
-        primvar->GetDeclarationInfo(&name, &typeName, 
-                                     &interpolation, &elementSize);
-        
-        if (interpolation == UsdGeomTokens->vertex or
-             interpolation == UsdGeomTokens->faceVarying)
+    if (reorderForPainting && !m_vertexIndices.empty())
+    {
+        if (_PointsCoverIndices())
         {
-            string prefix = name.GetString().substr(0,2);
-            string mapName("");
-        
-            if ((prefix == "v_" || prefix == "u_") and
-                (typeName == SdfValueTypeNames->FloatArray))
-            {
-                mapName = name.GetString().substr(2);
-            } else if (typeName == SdfValueTypeNames->TexCoord2fArray ||
-               (GeoData::ReadFloat2AsUV() &&
-                typeName == SdfValueTypeNames->Float2Array))
-            {
-                mapName = name.GetString();
-            }
-            if (mapName.length()) {
-                UVSet::iterator it = retval.find(mapName);
-                if (it == retval.end())
-                    retval[mapName] = 1;
-                else
-                    retval[mapName] += 1;
-            }
+            _ReorderForPainting();
+        }
+        else
+        {
+            MARI_USD_LOG_WARNING(log, "** Cannot reorder mesh %s, its points do not match its topology.", prim.GetPath().GetText());
+            log.Count("meshes not reordered", "points do not match the topology");
         }
     }
-}
 
-float* GeoData::GetVertices(int frameSample)
-{
-    if (m_vertices.size() > 0)
+    TfToken orientation;
+    m_leftHanded = mesh.GetOrientationAttr().Get(&orientation) && orientation == UsdGeomTokens->leftHanded;
+
+    // Generate normals once the creases and holes are known
+    if (generateNormals && m_normals.empty() && !m_vertexIndices.empty())
     {
-        if (m_vertices.find(frameSample) != m_vertices.end())
+        TRACE_SCOPE("GeoData: generate normals");
+        if (_PointsCoverIndices())
         {
-            return &(m_vertices[frameSample][0]);
+            _BuildSmoothGroups(GeoDataKernels::MaxIndex(m_vertexIndices.data(), m_vertexIndices.size()));
+            _GenerateNormals();
         }
         else
         {
-            // Could not find frame -> let's return frame 0
-            return &(m_vertices.begin()->second[0]);
+            MARI_USD_LOG_WARNING(log, "** Cannot generate normals for mesh %s, its points do not match its topology.", prim.GetPath().GetText());
+            log.Count("meshes without generated normals", "points do not match the topology");
         }
     }
 
-    // frame not found.
-    return NULL;
+    _ComputeTopologyFingerprint();
+    _ComputeUdimTiles();
 }
 
-void GeoData::Reset()
+GeoData::UvSetStatus GeoData::_ReadUvSet(UsdPrim const &prim,
+                                         const std::string &name,
+                                         bool isTopologyVarying,
+                                         int maxVertexIndex,
+                                         std::vector<float> &uvs,
+                                         std::vector<int> &uvIndices)
 {
-    m_vertexIndices.clear();
-    m_faceCounts.clear();
-    m_faceSelectionIndices.clear();
-
-    m_vertices.clear();
-
-    m_normalIndices.clear();
-    m_normals.clear();
+    UsdGeomPrimvarsAPI primvarsApi(prim);
+    UsdGeomPrimvar uvPrimvar = primvarsApi.GetPrimvar(TfToken(name));
+    if (!uvPrimvar)
+    {
+        // Legacy assets split their uvs into u_<name> and v_<name> floats
+        UsdGeomPrimvar uPrimvar = primvarsApi.GetPrimvar(TfToken(_tokens->uPrefix.GetString() + name));
+        UsdGeomPrimvar vPrimvar = primvarsApi.GetPrimvar(TfToken(_tokens->vPrefix.GetString() + name));
+        if (!uPrimvar || !vPrimvar)
+        {
+            return UvSetStatus::NotFound;
+        }
 
-    m_uvIndices.clear();
-    m_uvs.clear();
+        GeoDataKernels::Interpolation uInterpolation, vInterpolation;
+        if (!_GetInterpolation(uPrimvar.GetInterpolation(), uInterpolation) or
+            !_GetInterpolation(vPrimvar.GetInterpolation(), vInterpolation) or
+            uPrimvar.GetTypeName() != SdfValueTypeNames->FloatArray or
+            vPrimvar.GetTypeName() != SdfValueTypeNames->FloatArray)
+        {
+            return UvSetStatus::Unsupported;
+        }
 
-    m_creaseIndices.clear();
-    m_creaseLengths.clear();
-    m_creaseSharpness.clear();
-    m_cornerIndices.clear();
-    m_cornerSharpness.clear();
-    m_holeIndices.clear();
-}
+        VtFloatArray uValues, vValues;
+        VtIntArray uIndices, vIndices;
+        if (!uPrimvar.Get(&uValues, UsdTimeCode::EarliestTime()) or
+            !vPrimvar.Get(&vValues, UsdTimeCode::EarliestTime()))
+        {
+            return UvSetStatus::Unreadable;
+        }
+        isTopologyVarying ? uPrimvar.GetIndices(&uIndices, UsdTimeCode::EarliestTime()) : uPrimvar.GetIndices(&uIndices);
+        isTopologyVarying ? vPrimvar.GetIndices(&vIndices, UsdTimeCode::EarliestTime()) : vPrimvar.GetIndices(&vIndices);
+
+        // Each component is expanded on its own, as they can be indexed and
+        // interpolated differently
+        std::vector<float> u, v;
+        std::vector<int> uFaceVarying, vFaceVarying;
+        if (!_ExpandPrimvar(uValues, uIndices, uInterpolation, m_faceCounts, m_vertexIndices, m_faceArity, maxVertexIndex, u, uFaceVarying) or
+            !_ExpandPrimvar(vValues, vIndices, vInterpolation, m_faceCounts, m_vertexIndices, m_faceArity, maxVertexIndex, v, vFaceVarying))
+        {
+            return UvSetStatus::Mismatch;
+        }
 
-bool GeoData::TestPath(string path)
-{
-    bool requiredSubstringFound = true;
-    std::vector<std::string>::iterator i;
-    for (i=_requireGeomPathSubstring.begin(); i!=_requireGeomPathSubstring.end(); ++i)
-    {
-        if (path.find(*i) != string::npos)
+        if (uFaceVarying == vFaceVarying)
         {
-            requiredSubstringFound = true;
-            break;
-        } else {
-            requiredSubstringFound = false;
+            // Same layout: the components pair up value by value, and keep
+            // their indices
+            const size_t count = std::min(u.size(), v.size());
+            uvs.resize(count * 2);
+            GeoDataKernels::InterleaveUVs(u.data(), v.data(), count, uvs.data());
+            uvIndices.swap(uFaceVarying);
+        }
+        else
+        {
+            // Different layouts: one uv per face-vertex
+            uvs.resize(uFaceVarying.size() * 2);
+            GeoDataKernels::GatherInterleaveUVs(u.data(), uFaceVarying.data(), v.data(), vFaceVarying.data(),
+                                                uFaceVarying.size(), uvs.data());
+            uvIndices.resize(uFaceVarying.size());
+            GeoDataKernels::Iota(uvIndices.data(), uvIndices.size());
         }
+        return UvSetStatus::Read;
     }
 
-    if (requiredSubstringFound == false) 
+    const SdfValueTypeName typeName = uvPrimvar.GetTypeName();
+    GeoDataKernels::Interpolation interpolation;
+    if (!_GetInterpolation(uvPrimvar.GetInterpolation(), interpolation) or
+        !(typeName == SdfValueTypeNames->TexCoord2fArray or (GeoData::ReadFloat2AsUV() and typeName == SdfValueTypeNames->Float2Array)))
     {
-        return false;
+        return UvSetStatus::Unsupported;
     }
 
-    for (i=_ignoreGeomPathSubstring.begin(); i!=_ignoreGeomPathSubstring.end(); ++i)
+    VtVec2fArray values;
+    VtIntArray indices;
+    if (!uvPrimvar.Get(&values, UsdTimeCode::EarliestTime()))
     {
-        if (path.find(*i) != string::npos)
-        {
-            return false;
-        }
+        return UvSetStatus::Unreadable;
     }
-    return true;
+
+    // Indices are left empty if the uvs are not indexed
+    isTopologyVarying ? uvPrimvar.GetIndices(&indices, UsdTimeCode::EarliestTime()) : uvPrimvar.GetIndices(&indices);
+
+    if (!_ExpandPrimvar(values, indices, interpolation, m_faceCounts, m_vertexIndices, m_faceArity, maxVertexIndex, uvs, uvIndices))
+    {
+        return UvSetStatus::Mismatch;
+    }
+    return UvSetStatus::Read;
 }
-    
 
-void GeoData::InitializePathSubstringLists()
+void GeoData::_ShareUvIndices(AdditionalUvSet &uvSet)
 {
-    char * ignoreEnv = getenv(_ignoreGeomPathSubstringEnvVar.c_str());
-    char * requireEnv = getenv(_requireGeomPathSubstringEnvVar.c_str());
-    
-    if (ignoreEnv) 
+    if (!m_uvs.empty() && uvSet.indices == m_uvIndices)
     {
-        _ignoreGeomPathSubstring.clear();
-        _ignoreGeomPathSubstring = TfStringTokenize(ignoreEnv, ",");
+        uvSet.indicesOf = 0;
     }
-
-    if (requireEnv) 
+    else
+    {
+        for (size_t i = 0; i < m_additionalUvSets.size(); ++i)
+        {
+            if (m_additionalUvSets[i].indicesOf < 0 && uvSet.indices == m_additionalUvSets[i].indices)
+            {
+                uvSet.indicesOf = int(i) + 1;
+                break;
+            }
+        }
+    }
+    if (uvSet.indicesOf >= 0)
     {
-        _requireGeomPathSubstring.clear();
-        _requireGeomPathSubstring = TfStringTokenize(requireEnv, ",");
+        std::vector<int>().swap(uvSet.indices);
     }
 }
 
+const std::vector<int>& GeoData::GetAdditionalUvIndices(size_t set)
+{
+    GeoData &channels = _Channels();
+    const AdditionalUvSet &uvSet = channels.m_additionalUvSets[set];
+    if (uvSet.indicesOf < 0)
+        return uvSet.indices;
+    if (uvSet.indicesOf == 0)
+        return channels.m_uvIndices;
+    return channels.m_additionalUvSets[uvSet.indicesOf - 1].indices;
+}
+
+GeoData::GeoData(const std::shared_ptr<GeoData> &original,
+                 UsdPrim const &prim,
+                 std::vector<int> frames,
+                 bool conformToMariY,
+                 bool readerIsUpY,
+                 bool keepCentered,
+                 UsdPrim const &model,
+                 ImportLog& log) :
+    m_isSubdivMesh(false),
+    m_interpolateBoundary(0),
+    m_faceVaryingLinearInterpolation(0),
+    m_propagateCorner(0),
+    m_triangleSubdivision(0),
+    m_rejectReason(original->m_rejectReason),
+    m_channels(original)
+{
+    TRACE_FUNCTION();
+
+    if (m_rejectReason.empty())
+    {
+        // The smooth groups and kept points are shared, the normals
+        // follow the points
+        if (_ReadPoints(prim, frames, conformToMariY, readerIsUpY, keepCentered, model, log) &&
+            _GatherPoints(original->m_pointSources) &&
+            !original->m_smoothGroupOffsets.empty())
+        {
+            _GenerateNormals();
+        }
+    }
+}
+
+bool GeoData::_ReadPoints(UsdPrim const &prim,
+                          const std::vector<int> &frames,
+                          bool conformToMariY,
+                          bool readerIsUpY,
+                          bool keepCentered,
+                          UsdPrim const &model,
+                          ImportLog& log)
+{
+    UsdGeomMesh mesh(prim);
+    GfMatrix4d const IDENTITY(1);
+    vector<float> points;
+    for (unsigned int iFrame = 0; iFrame < frames.size(); ++iFrame) 
+    {
+        TRACE_SCOPE("GeoData: read points");
+        // Get frame sample corresponding to frame index
+        unsigned int frameSample = frames[iFrame];
+        double currentTime = double(frameSample);
+
+        // Read points for this frame sample
+        VtVec3fArray pointsVt;
+        if (!mesh.GetPointsAttr().Get(&pointsVt, frameSample))
+        {
+            MARI_USD_LOG_WARNING(log, "** Failed getting points on %s", prim.GetPath().GetText());
+            m_rejectReason = "cannot read points";
+            return false;
+        }
+        
+        points.resize(pointsVt.size() * 3);
+        GeoDataKernels::FlattenTuples<3>(pointsVt.cdata(), pointsVt.size(), points.data());
+
+        // Calculate transforms - if not identity, pre-transform all points in place
+        UsdGeomXformCache xformCache(currentTime);
+        GfMatrix4d fullXform = xformCache.GetLocalToWorldTransform(prim);
+
+        if (keepCentered)
+        {
+            // ignore transforms up to the model level
+            GfMatrix4d m = xformCache.GetLocalToWorldTransform(model);
+            fullXform = fullXform * m.GetInverse();
+        }
+        if (fullXform != IDENTITY)
+        {
+            TRACE_SCOPE("GeoData: transform points");
+            GeoDataKernels::TransformPoints(points.data(), pointsVt.size(), fullXform.GetArray());
+        }
+
+        if (conformToMariY && !readerIsUpY)
+        {
+            // Our source is Z and we need to conform to Y -> let's flip
+            GeoDataKernels::SwizzleZUpToYUp(points.data(), pointsVt.size());
+        }
+
+        // Insert transformed vertices in our map
+        m_vertices[frameSample].resize(points.size());
+        m_vertices[frameSample] = points;
+    }
+
+    return true;
+}
+
+GeoData::GeoData(const std::vector<GeoData*> &sources,
+                 const std::vector<std::string> &labels)
+{
+    TRACE_FUNCTION();
+
+    const GeoData &first = sources.front()->_Channels();
+    m_isSubdivMesh = first.m_isSubdivMesh;
+    m_subdivisionScheme = first.m_subdivisionScheme;
+    m_interpolateBoundary = first.m_interpolateBoundary;
+    m_faceVaryingLinearInterpolation = first.m_faceVaryingLinearInterpolation;
+    m_propagateCorner = first.m_propagateCorner;
+    m_triangleSubdivision = first.m_triangleSubdivision;
+
+    // Where each source starts in the concatenated arrays. The extra entry
+    // at the end holds the totals.
+    struct Offsets
+    {
+        size_t points = 0;
+        size_t faces = 0;
+        size_t faceVertices = 0;
+        size_t normals = 0;
+        size_t normalIndices = 0;
+        size_t uvs = 0;
+        size_t uvIndices = 0;
+        size_t creaseIndices = 0;
+        size_t creaseLengths = 0;
+        size_t creaseSharpness = 0;
+        size_t corners = 0;
+        size_t cornerSharpness = 0;
+        size_t holes = 0;
+    };
+    std::vector<Offsets> offsets(sources.size() + 1);
+    std::set<int> frames;
+    // Any generated normals make the concatenated ones change per frame
+    bool perFrameNormals = false;
+    // Face sources stay relative to each source mesh, like its SourceRange
+    bool hasFaceSources = false;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        const GeoData &src = sources[i]->_Channels();
+        const Offsets &o = offsets[i];
+        Offsets &n = offsets[i + 1];
+        n.points = o.points + sources[i]->m_vertices.begin()->second.size() / 3;
+        n.faces = o.faces + src.m_faceCounts.size();
+        n.faceVertices = o.faceVertices + src.m_vertexIndices.size();
+        n.normals = o.normals + sources[i]->GetNumNormals() / 3;
+        n.normalIndices = o.normalIndices + src.m_normalIndices.size();
+        n.uvs = o.uvs + src.m_uvs.size() / 2;
+        n.uvIndices = o.uvIndices + src.m_uvIndices.size();
+        n.creaseIndices = o.creaseIndices + src.m_creaseIndices.size();
+        n.creaseLengths = o.creaseLengths + src.m_creaseLengths.size();
+        n.creaseSharpness = o.creaseSharpness + src.m_creaseSharpness.size();
+        n.corners = o.corners + src.m_cornerIndices.size();
+        n.cornerSharpness = o.cornerSharpness + src.m_cornerSharpness.size();
+        n.holes = o.holes + src.m_holeIndices.size();
+
+        for (const auto &it : sources[i]->m_vertices)
+        {
+            frames.insert(it.first);
+        }
+        perFrameNormals = perFrameNormals || sources[i]->HasGeneratedNormals();
+        hasFaceSources = hasFaceSources || !src.m_faceSources.empty();
+        m_udimTiles |= src.m_udimTiles;
+        m_facesOutsideUdims += src.m_facesOutsideUdims;
+
+        SourceRange range;
+        range.label = labels[i];
+        range.firstFace = o.faces;
+        range.numFaces = src.m_faceCounts.size();
+        m_sourceRanges.push_back(range);
+    }
+
+    const Offsets &total = offsets.back();
+    for (int frame : frames)
+    {
+        m_vertices[frame].resize(total.points * 3);
+    }
+    m_vertexIndices.resize(total.faceVertices);
+    m_faceCounts.resize(total.faces);
+    m_faceSelectionIndices.resize(total.faces);
+    GeoDataKernels::Iota(m_faceSelectionIndices.data(), total.faces);
+    m_normalIndices.resize(total.normalIndices);
+    if (perFrameNormals)
+    {
+        for (int frame : frames)
+        {
+            m_generatedNormals[frame].resize(total.normals * 3);
+        }
+    }
+    else
+    {
+        m_normals.resize(total.normals * 3);
+    }
+    m_uvIndices.resize(total.uvIndices);
+    m_uvs.resize(total.uvs * 2);
+    m_creaseIndices.resize(total.creaseIndices);
+    m_creaseLengths.resize(total.creaseLengths);
+    m_creaseSharpness.resize(total.creaseSharpness);
+    m_cornerIndices.resize(total.corners);
+    m_cornerSharpness.resize(total.cornerSharpness);
+    m_holeIndices.resize(total.holes);
+    if (hasFaceSources)
+    {
+        m_faceSources.resize(total.faces);
+    }
+
+    // The additional uv sets have the same names in every source, as they
+    // are part of the consolidation key
+    const size_t numAdditionalUvSets = first.m_additionalUvSets.size();
+    std::vector<std::vector<size_t> > additionalUvOffsets(numAdditionalUvSets, std::vector<size_t>(sources.size() + 1, 0));
+    m_additionalUvSets.resize(numAdditionalUvSets);
+    for (size_t set = 0; set < numAdditionalUvSets; ++set)
+    {
+        std::vector<size_t> &setOffsets = additionalUvOffsets[set];
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            setOffsets[i + 1] = setOffsets[i] + sources[i]->GetAdditionalUvSets()[set].uvs.size() / 2;
+        }
+        m_additionalUvSets[set].name = first.m_additionalUvSets[set].name;
+        m_additionalUvSets[set].uvs.resize(setOffsets.back() * 2);
+        m_additionalUvSets[set].indices.resize(total.faceVertices);
+    }
+
+    // Each source writes its own slice of every array
+    WorkParallelForN(sources.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const GeoData &src = sources[i]->_Channels();
+            const Offsets &o = offsets[i];
+
+            for (auto &it : m_vertices)
+            {
+                const float *points = sources[i]->GetVertices(it.first);
+                std::copy(points, points + sources[i]->GetNumPoints(), it.second.data() + o.points * 3);
+            }
+
+            GeoDataKernels::OffsetIndices(src.m_vertexIndices.data(), src.m_vertexIndices.size(),
+                                          int(o.points), m_vertexIndices.data() + o.faceVertices);
+            std::copy(src.m_faceCounts.begin(), src.m_faceCounts.end(), m_faceCounts.begin() + o.faces);
+
+            GeoDataKernels::OffsetIndices(src.m_normalIndices.data(), src.m_normalIndices.size(),
+                                          int(o.normals), m_normalIndices.data() + o.normalIndices);
+            if (perFrameNormals)
+            {
+                for (auto &it : m_generatedNormals)
+                {
+                    const float *normals = sources[i]->GetNormals(it.first);
+                    std::copy(normals, normals + sources[i]->GetNumNormals(), it.second.data() + o.normals * 3);
+                }
+            }
+            else
+            {
+                std::copy(src.m_normals.begin(), src.m_normals.end(), m_normals.begin() + o.normals * 3);
+            }
+
+            GeoDataKernels::OffsetIndices(src.m_uvIndices.data(), src.m_uvIndices.size(),
+                                          int(o.uvs), m_uvIndices.data() + o.uvIndices);
+            std::copy(src.m_uvs.begin(), src.m_uvs.end(), m_uvs.begin() + o.uvs * 2);
+
+            GeoDataKernels::OffsetIndices(src.m_creaseIndices.data(), src.m_creaseIndices.size(),
+                                          int(o.points), m_creaseIndices.data() + o.creaseIndices);
+            std::copy(src.m_creaseLengths.begin(), src.m_creaseLengths.end(), m_creaseLengths.begin() + o.creaseLengths);
+            std::copy(src.m_creaseSharpness.begin(), src.m_creaseSharpness.end(), m_creaseSharpness.begin() + o.creaseSharpness);
+            GeoDataKernels::OffsetIndices(src.m_cornerIndices.data(), src.m_cornerIndices.size(),
+                                          int(o.points), m_cornerIndices.data() + o.corners);
+            std::copy(src.m_cornerSharpness.begin(), src.m_cornerSharpness.end(), m_cornerSharpness.begin() + o.cornerSharpness);
+            GeoDataKernels::OffsetIndices(src.m_holeIndices.data(), src.m_holeIndices.size(),
+                                          int(o.faces), m_holeIndices.data() + o.holes);
+            if (hasFaceSources && src.m_faceSources.empty())
+            {
+                GeoDataKernels::Iota(m_faceSources.data() + o.faces, src.m_faceCounts.size());
+            }
+            else if (hasFaceSources)
+            {
+                std::copy(src.m_faceSources.begin(), src.m_faceSources.end(), m_faceSources.begin() + o.faces);
+            }
+
+            for (size_t set = 0; set < numAdditionalUvSets; ++set)
+            {
+                const std::vector<float> &uvs = src.m_additionalUvSets[set].uvs;
+                const std::vector<int> &uvIndices = sources[i]->GetAdditionalUvIndices(set);
+                const size_t uvOffset = additionalUvOffsets[set][i];
+                GeoDataKernels::OffsetIndices(uvIndices.data(), uvIndices.size(),
+                                              int(uvOffset), m_additionalUvSets[set].indices.data() + o.faceVertices);
+                std::copy(uvs.begin(), uvs.end(), m_additionalUvSets[set].uvs.begin() + uvOffset * 2);
+            }
+        }
+    });
+
+    // Sharing is found again on the concatenated indices
+    std::vector<AdditionalUvSet> additionalUvSets;
+    additionalUvSets.swap(m_additionalUvSets);
+    for (AdditionalUvSet &uvSet : additionalUvSets)
+    {
+        _ShareUvIndices(uvSet);
+        m_additionalUvSets.push_back(std::move(uvSet));
+    }
+
+    m_faceArity = GeoDataKernels::UniformFaceArity(m_faceCounts.data(), m_faceCounts.size());
+    _ComputeTopologyFingerprint();
+}
+
+// Hashes the array a block at a time, in parallel, then hashes the hashes of
+// the blocks. The blocks do not depend on the number of threads, so neither
+// does the result.
+static uint64_t _HashIndexBlocks(const std::vector<int> &indices, uint64_t seed)
+{
+    const size_t numBlocks = (indices.size() + _fingerprintBlockSize - 1) / _fingerprintBlockSize;
+    std::vector<uint64_t> blockHashes(numBlocks);
+    WorkParallelForN(numBlocks, [&](size_t begin, size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t first = block * _fingerprintBlockSize;
+            const size_t count = std::min(_fingerprintBlockSize, indices.size() - first);
+            blockHashes[block] = GeoDataKernels::Hash64(indices.data() + first, count * sizeof(int), 0);
+        }
+    });
+    return GeoDataKernels::Hash64(blockHashes.data(), numBlocks * sizeof(uint64_t), seed);
+}
+
+void GeoData::_ComputeTopologyFingerprint()
+{
+    TRACE_FUNCTION();
+
+    uint64_t fingerprint = 0;
+    fingerprint = _HashIndexBlocks(m_faceCounts, fingerprint);
+    fingerprint = _HashIndexBlocks(m_vertexIndices, fingerprint);
+    fingerprint = _HashIndexBlocks(m_uvIndices, fingerprint);
+    m_topologyFingerprint = fingerprint;
+}
+
+// 64 bit face offsets: the face vertices of huge meshes overflow an int
+static std::vector<size_t> _GetFaceOffsets(const std::vector<int> &faceCounts)
+{
+    std::vector<size_t> faceOffsets(faceCounts.size() + 1, 0);
+    for (size_t face = 0; face < faceCounts.size(); ++face)
+    {
+        faceOffsets[face + 1] = faceOffsets[face] + size_t(faceCounts[face]);
+    }
+    return faceOffsets;
+}
+
+// The tiles are marked a block of faces at a time, in parallel, each block
+// into its own set
+void GeoData::_ComputeUdimTiles()
+{
+    TRACE_FUNCTION();
+
+    m_udimTiles.reset();
+    m_facesOutsideUdims = 0;
+    if (m_uvs.empty() || m_uvIndices.size() != m_vertexIndices.size() ||
+        !GeoDataKernels::IndicesInRange(m_uvIndices.data(), m_uvIndices.size(), m_uvs.size() / 2))
+    {
+        return;
+    }
+    const std::vector<size_t> faceOffsets = _GetFaceOffsets(m_faceCounts);
+    if (faceOffsets.back() != m_uvIndices.size())
+    {
+        return;
+    }
+
+    const size_t numFaces = m_faceCounts.size();
+    const size_t numBlocks = (numFaces + _udimBlockSize - 1) / _udimBlockSize;
+    std::vector<GeoDataKernels::UdimTiles> blockTiles(numBlocks);
+    std::vector<size_t> blockOutside(numBlocks, 0);
+    WorkParallelForN(numBlocks, [&](size_t begin, size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t first = block * _udimBlockSize;
+            const size_t last = std::min(first + _udimBlockSize, numFaces);
+            blockOutside[block] = GeoDataKernels::MarkUdimTiles(m_uvs.data(), m_uvIndices.data(), faceOffsets.data(),
+                                                                first, last, blockTiles[block]);
+        }
+    });
+    for (size_t block = 0; block < numBlocks; ++block)
+    {
+        m_udimTiles |= blockTiles[block];
+        m_facesOutsideUdims += blockOutside[block];
+    }
+}
+
+bool GeoData::_PointsCoverIndices() const
+{
+    if (m_vertices.empty() ||
+        GeoDataKernels::Sum(m_faceCounts.data(), m_faceCounts.size()) != m_vertexIndices.size())
+    {
+        return false;
+    }
+    for (const auto &it : m_vertices)
+    {
+        if (!GeoDataKernels::IndicesInRange(m_vertexIndices.data(), m_vertexIndices.size(), it.second.size() / 3))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// sources[i] = sources[newSources[i]], or newSources if there were none:
+// where each element came from after two renumberings
+static void _ComposeSources(std::vector<int> &sources, const std::vector<int> &newSources)
+{
+    if (sources.empty())
+    {
+        sources = newSources;
+        return;
+    }
+    std::vector<int> composed(newSources.size());
+    for (size_t i = 0; i < newSources.size(); ++i)
+    {
+        composed[i] = sources[newSources[i]];
+    }
+    sources.swap(composed);
+}
+
+void GeoData::_CleanUp(UsdPrim const &prim, ImportLog& log)
+{
+    TRACE_FUNCTION();
+
+    if (!_PointsCoverIndices())
+    {
+        MARI_USD_LOG_WARNING(log, "** Cannot clean up mesh %s, its points do not match its topology.", prim.GetPath().GetText());
+        log.Count("meshes not cleaned up", "points do not match the topology");
+        return;
+    }
+
+    const size_t numFaces = m_faceCounts.size();
+    const size_t numPoints = m_vertices.begin()->second.size() / 3;
+    const std::vector<size_t> faceOffsets = _GetFaceOffsets(m_faceCounts);
+
+    // Faces with fewer than three distinct points are removed, the others
+    // are removed if they have no area at any of the frames
+    std::vector<unsigned char> removed(numFaces, 0);
+    std::vector<unsigned char> zeroArea(numFaces, 0);
+    WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+    {
+        std::vector<int> facePoints;
+        for (size_t face = begin; face < end; ++face)
+        {
+            facePoints.assign(m_vertexIndices.begin() + faceOffsets[face], m_vertexIndices.begin() + faceOffsets[face + 1]);
+            std::sort(facePoints.begin(), facePoints.end());
+            const bool tooFewPoints = std::unique(facePoints.begin(), facePoints.end()) - facePoints.begin() < 3;
+            removed[face] = tooFewPoints;
+            zeroArea[face] = !tooFewPoints;
+        }
+    });
+    for (const auto &it : m_vertices)
+    {
+        WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+        {
+            GeoDataKernels::ClearFacesWithArea(it.second.data(), m_vertexIndices.data(), faceOffsets.data(),
+                                               begin, end, zeroArea.data());
+        });
+    }
+
+    // The faces left, and the points they use, in order
+    std::vector<int> keptFaces;
+    std::vector<int> pointRemap(numPoints, -1);
+    for (size_t face = 0; face < numFaces; ++face)
+    {
+        if (removed[face] || zeroArea[face])
+        {
+            continue;
+        }
+        keptFaces.push_back(int(face));
+        for (size_t i = faceOffsets[face]; i < faceOffsets[face + 1]; ++i)
+        {
+            pointRemap[m_vertexIndices[i]] = 0;
+        }
+    }
+    std::vector<int> keptPoints;
+    for (size_t point = 0; point < numPoints; ++point)
+    {
+        if (pointRemap[point] == 0)
+        {
+            pointRemap[point] = int(keptPoints.size());
+            keptPoints.push_back(int(point));
+        }
+    }
+
+    m_removedFaces = numFaces - keptFaces.size();
+    m_removedPoints = numPoints - keptPoints.size();
+    if (m_removedFaces == 0 && m_removedPoints == 0)
+    {
+        return;
+    }
+    log.Count("meshes cleaned up", "unused points or degenerate faces removed");
+    if (keptFaces.empty())
+    {
+        m_rejectReason = "only degenerate faces";
+        m_vertexIndices.clear();
+        m_faceCounts.clear();
+        return;
+    }
+
+    _RemapFaces(keptFaces, pointRemap);
+    if (m_removedPoints > 0)
+    {
+        _GatherPoints(keptPoints);
+        _ComposeSources(m_pointSources, keptPoints);
+    }
+}
+
+void GeoData::_SortFacesByTile(const std::vector<size_t> &faceOffsets, std::vector<std::pair<uint64_t, int> > &keys)
+{
+    TRACE_FUNCTION();
+
+    const size_t numFaces = m_faceCounts.size();
+    const float *points = m_vertices.begin()->second.data();
+
+    // Face centres at the first frame, and their bounds
+    std::vector<float> centres(numFaces * 3, 0.0f);
+    WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+    {
+        GeoDataKernels::FaceCentres(points, 3, m_vertexIndices.data(), faceOffsets.data(), begin, end, centres.data());
+    });
+    float lower[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float upper[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (size_t face = 0; face < numFaces; ++face)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            lower[axis] = std::min(lower[axis], centres[face * 3 + axis]);
+            upper[axis] = std::max(upper[axis], centres[face * 3 + axis]);
+        }
+    }
+
+    // Uv centres give the tile of each face, when there are uvs
+    const bool hasTiles = m_uvIndices.size() == m_vertexIndices.size() && m_uvs.size() >= 2 &&
+                          GeoDataKernels::IndicesInRange(m_uvIndices.data(), m_uvIndices.size(), m_uvs.size() / 2);
+    std::vector<float> uvCentres(hasTiles ? numFaces * 2 : 0);
+    if (hasTiles)
+    {
+        WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+        {
+            GeoDataKernels::FaceCentres(m_uvs.data(), 2, m_uvIndices.data(), faceOffsets.data(), begin, end, uvCentres.data());
+        });
+    }
+
+    // Faces sorted by tile, then along a Morton curve through their centres
+    keys.resize(numFaces);
+    WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+    {
+        for (size_t face = begin; face < end; ++face)
+        {
+            unsigned cell[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float extent = upper[axis] - lower[axis];
+                const float t = extent > 0.0f ? (centres[face * 3 + axis] - lower[axis]) / extent : 0.0f;
+                cell[axis] = unsigned(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f);
+            }
+            uint64_t tile = 0;
+            if (hasTiles)
+            {
+                const float u = std::min(std::max(std::floor(uvCentres[face * 2]), 0.0f), 9.0f);
+                const float v = std::min(std::max(std::floor(uvCentres[face * 2 + 1]), 0.0f), 6552.0f);
+                tile = uint64_t(u + 10.0f * v);
+            }
+            keys[face] = std::make_pair((tile << 48) | GeoDataKernels::Morton48(cell[0], cell[1], cell[2]), int(face));
+        }
+    });
+    WorkParallelSort(&keys);
+}
+
+void GeoData::_ReorderForPainting()
+{
+    TRACE_FUNCTION();
+
+    const size_t numFaces = m_faceCounts.size();
+    const size_t numPoints = m_vertices.begin()->second.size() / 3;
+    const std::vector<size_t> faceOffsets = _GetFaceOffsets(m_faceCounts);
+    std::vector<std::pair<uint64_t, int> > keys;
+    _SortFacesByTile(faceOffsets, keys);
+
+    std::vector<int> order(numFaces);
+    for (size_t i = 0; i < numFaces; ++i)
+    {
+        order[i] = keys[i].second;
+    }
+
+    // Points in order of first use by the sorted faces, then those no face
+    // uses, in their own order
+    std::vector<int> pointRemap(numPoints, -1);
+    std::vector<int> pointOrder;
+    pointOrder.reserve(numPoints);
+    for (int face : order)
+    {
+        for (size_t i = faceOffsets[face]; i < faceOffsets[face + 1]; ++i)
+        {
+            int &point = pointRemap[m_vertexIndices[i]];
+            if (point < 0)
+            {
+                point = int(pointOrder.size());
+                pointOrder.push_back(m_vertexIndices[i]);
+            }
+        }
+    }
+    for (size_t point = 0; point < numPoints; ++point)
+    {
+        if (pointRemap[point] < 0)
+        {
+            pointRemap[point] = int(pointOrder.size());
+            pointOrder.push_back(int(point));
+        }
+    }
+
+    _RemapFaces(order, pointRemap);
+    _GatherPoints(pointOrder);
+    _ComposeSources(m_pointSources, pointOrder);
+}
+
+void GeoData::_RemapFaces(const std::vector<int> &faceSources, const std::vector<int> &pointRemap)
+{
+    TRACE_FUNCTION();
+
+    const size_t numFaces = m_faceCounts.size();
+    const size_t numFaceVertices = m_vertexIndices.size();
+    const size_t numPoints = pointRemap.size();
+    const size_t numNewFaces = faceSources.size();
+
+    const std::vector<size_t> faceOffsets = _GetFaceOffsets(m_faceCounts);
+    std::vector<int> faceCounts(numNewFaces);
+    std::vector<size_t> newFaceOffsets(numNewFaces + 1, 0);
+    for (size_t face = 0; face < numNewFaces; ++face)
+    {
+        faceCounts[face] = m_faceCounts[faceSources[face]];
+        newFaceOffsets[face + 1] = newFaceOffsets[face] + faceCounts[face];
+    }
+
+    // Each new face copies the face varying entries of its source, the
+    // vertex indices renumbered
+    auto remapFaceVarying = [&](std::vector<int> &values, bool arePoints)
+    {
+        if (values.size() != numFaceVertices)
+        {
+            return;
+        }
+        std::vector<int> remapped(newFaceOffsets.back());
+        WorkParallelForN(numNewFaces, [&](size_t begin, size_t end)
+        {
+            for (size_t face = begin; face < end; ++face)
+            {
+                const int source = faceSources[face];
+                int *out = remapped.data() + newFaceOffsets[face];
+                for (size_t i = faceOffsets[source]; i < faceOffsets[source + 1]; ++i)
+                {
+                    *out++ = arePoints ? pointRemap[values[i]] : values[i];
+                }
+            }
+        });
+        values.swap(remapped);
+    };
+    remapFaceVarying(m_vertexIndices, true);
+    remapFaceVarying(m_uvIndices, false);
+    remapFaceVarying(m_normalIndices, false);
+    for (AdditionalUvSet &uvSet : m_additionalUvSets)
+    {
+        remapFaceVarying(uvSet.indices, false);
+    }
+
+    m_faceCounts.swap(faceCounts);
+    m_faceArity = GeoDataKernels::UniformFaceArity(m_faceCounts.data(), m_faceCounts.size());
+    m_faceSelectionIndices.resize(numNewFaces);
+    GeoDataKernels::Iota(m_faceSelectionIndices.data(), numNewFaces);
+
+    std::vector<int> faceRemap(numFaces, -1);
+    for (size_t face = 0; face < numNewFaces; ++face)
+    {
+        faceRemap[faceSources[face]] = int(face);
+    }
+    std::vector<int> holeIndices;
+    for (int face : m_holeIndices)
+    {
+        if (face >= 0 && size_t(face) < numFaces && faceRemap[face] >= 0)
+        {
+            holeIndices.push_back(faceRemap[face]);
+        }
+    }
+    m_holeIndices.swap(holeIndices);
+    _ComposeSources(m_faceSources, faceSources);
+
+    // A crease or corner on a removed point goes with it
+    _RemapCreasesAndCorners([&](int point)
+    {
+        return point >= 0 && size_t(point) < numPoints ? pointRemap[point] : -1;
+    });
+}
+
+void GeoData::_RemapCreasesAndCorners(const std::function<int(int)> &pointRemap)
+{
+    {
+        const size_t numCreaseEdges = m_creaseIndices.size() > m_creaseLengths.size() ? m_creaseIndices.size() - m_creaseLengths.size() : 0;
+        const bool perEdgeSharpness = m_creaseSharpness.size() == numCreaseEdges && m_creaseSharpness.size() != m_creaseLengths.size();
+        std::vector<int> creaseIndices, creaseLengths;
+        std::vector<float> creaseSharpness;
+        size_t first = 0;
+        size_t edge = 0;
+        for (size_t crease = 0; crease < m_creaseLengths.size(); ++crease)
+        {
+            const size_t length = size_t(std::max(m_creaseLengths[crease], 0));
+            const size_t numEdges = length > 0 ? length - 1 : 0;
+            bool keep = first + length <= m_creaseIndices.size();
+            for (size_t i = 0; keep && i < length; ++i)
+            {
+                keep = pointRemap(m_creaseIndices[first + i]) >= 0;
+            }
+            if (keep)
+            {
+                for (size_t i = 0; i < length; ++i)
+                {
+                    creaseIndices.push_back(pointRemap(m_creaseIndices[first + i]));
+                }
+                creaseLengths.push_back(int(length));
+                if (perEdgeSharpness)
+                {
+                    creaseSharpness.insert(creaseSharpness.end(), m_creaseSharpness.begin() + edge,
+                                           m_creaseSharpness.begin() + edge + numEdges);
+                }
+                else if (crease < m_creaseSharpness.size())
+                {
+                    creaseSharpness.push_back(m_creaseSharpness[crease]);
+                }
+            }
+            first += length;
+            edge += numEdges;
+        }
+        m_creaseIndices.swap(creaseIndices);
+        m_creaseLengths.swap(creaseLengths);
+        m_creaseSharpness.swap(creaseSharpness);
+    }
+    {
+        std::vector<int> cornerIndices;
+        std::vector<float> cornerSharpness;
+        for (size_t corner = 0; corner < m_cornerIndices.size(); ++corner)
+        {
+            if (pointRemap(m_cornerIndices[corner]) >= 0)
+            {
+                cornerIndices.push_back(pointRemap(m_cornerIndices[corner]));
+                if (corner < m_cornerSharpness.size())
+                {
+                    cornerSharpness.push_back(m_cornerSharpness[corner]);
+                }
+            }
+        }
+        m_cornerIndices.swap(cornerIndices);
+        m_cornerSharpness.swap(cornerSharpness);
+    }
+}
+
+bool GeoData::_GatherPoints(const std::vector<int> &pointSources)
+{
+    if (pointSources.empty())
+    {
+        return true;
+    }
+
+    TRACE_FUNCTION();
+    const size_t maxSource = size_t(*std::max_element(pointSources.begin(), pointSources.end()));
+    for (auto &it : m_vertices)
+    {
+        const std::vector<float> &points = it.second;
+        if (maxSource >= points.size() / 3)
+        {
+            m_rejectReason = "points do not match the mesh they duplicate";
+            m_vertices.clear();
+            return false;
+        }
+
+        std::vector<float> gathered(pointSources.size() * 3);
+        WorkParallelForN(pointSources.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float *p = points.data() + 3 * pointSources[i];
+                std::copy(p, p + 3, gathered.data() + 3 * i);
+            }
+        });
+        it.second.swap(gathered);
+    }
+    return true;
+}
+
+// Renumbers the indices to the distinct values they use, in ascending
+// order, and returns those values
+static std::vector<int> _CompactIndices(std::vector<int> &indices)
+{
+    std::vector<int> used(indices);
+    WorkParallelSort(&used);
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+    WorkParallelForN(indices.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            indices[i] = int(std::lower_bound(used.begin(), used.end(), indices[i]) - used.begin());
+        }
+    });
+    return used;
+}
+
+// gathered[i] = values[sources[i]], for tuples of the given size; tuples
+// out of range are left at zero
+static void _GatherValues(const std::vector<float> &values,
+                          const std::vector<int> &sources,
+                          size_t components,
+                          std::vector<float> &gathered)
+{
+    gathered.assign(sources.size() * components, 0.0f);
+    WorkParallelForN(sources.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const size_t first = size_t(sources[i]) * components;
+            if (sources[i] >= 0 && first + components <= values.size())
+            {
+                std::copy(values.begin() + first, values.begin() + first + components, gathered.begin() + i * components);
+            }
+        }
+    });
+}
+
+GeoData::GeoData(GeoData &source,
+                 const std::vector<int> &faces,
+                 const std::vector<size_t> &faceOffsets,
+                 const std::string &label)
+{
+    TRACE_FUNCTION();
+
+    GeoData &channels = source._Channels();
+    m_isSubdivMesh = channels.m_isSubdivMesh;
+    m_subdivisionScheme = channels.m_subdivisionScheme;
+    m_interpolateBoundary = channels.m_interpolateBoundary;
+    m_faceVaryingLinearInterpolation = channels.m_faceVaryingLinearInterpolation;
+    m_propagateCorner = channels.m_propagateCorner;
+    m_triangleSubdivision = channels.m_triangleSubdivision;
+    m_leftHanded = channels.m_leftHanded;
+
+    const size_t numFaces = faces.size();
+    std::vector<size_t> partOffsets(numFaces + 1, 0);
+    m_faceCounts.resize(numFaces);
+    for (size_t face = 0; face < numFaces; ++face)
+    {
+        m_faceCounts[face] = channels.m_faceCounts[faces[face]];
+        partOffsets[face + 1] = partOffsets[face] + size_t(m_faceCounts[face]);
+    }
+
+    // The face varying entries of the faces, then the points, normals and
+    // uvs they use, renumbered in order
+    auto gatherFaceVarying = [&](const std::vector<int> &values, std::vector<int> &gathered)
+    {
+        if (values.size() != faceOffsets.back())
+        {
+            return;
+        }
+        gathered.resize(partOffsets.back());
+        WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+        {
+            for (size_t face = begin; face < end; ++face)
+            {
+                std::copy(values.begin() + faceOffsets[faces[face]], values.begin() + faceOffsets[faces[face] + 1],
+                          gathered.begin() + partOffsets[face]);
+            }
+        });
+    };
+
+    gatherFaceVarying(channels.m_vertexIndices, m_vertexIndices);
+    const std::vector<int> pointSources = _CompactIndices(m_vertexIndices);
+    for (const auto &it : source.m_vertices)
+    {
+        _GatherValues(it.second, pointSources, 3, m_vertices[it.first]);
+    }
+
+    gatherFaceVarying(channels.m_normalIndices, m_normalIndices);
+    const std::vector<int> normalSources = _CompactIndices(m_normalIndices);
+    if (source.HasGeneratedNormals())
+    {
+        for (const auto &it : source.m_generatedNormals)
+        {
+            _GatherValues(it.second, normalSources, 3, m_generatedNormals[it.first]);
+        }
+    }
+    else if (!m_normalIndices.empty())
+    {
+        _GatherValues(channels.m_normals, normalSources, 3, m_normals);
+    }
+
+    gatherFaceVarying(channels.m_uvIndices, m_uvIndices);
+    if (!m_uvIndices.empty())
+    {
+        _GatherValues(channels.m_uvs, _CompactIndices(m_uvIndices), 2, m_uvs);
+    }
+    for (size_t set = 0; set < channels.m_additionalUvSets.size(); ++set)
+    {
+        AdditionalUvSet uvSet;
+        uvSet.name = channels.m_additionalUvSets[set].name;
+        gatherFaceVarying(source.GetAdditionalUvIndices(set), uvSet.indices);
+        _GatherValues(channels.m_additionalUvSets[set].uvs, _CompactIndices(uvSet.indices), 2, uvSet.uvs);
+        _ShareUvIndices(uvSet);
+        m_additionalUvSets.push_back(std::move(uvSet));
+    }
+
+    // A crease or corner on a point out of the part is left out of it
+    m_creaseIndices = channels.m_creaseIndices;
+    m_creaseLengths = channels.m_creaseLengths;
+    m_creaseSharpness = channels.m_creaseSharpness;
+    m_cornerIndices = channels.m_cornerIndices;
+    m_cornerSharpness = channels.m_cornerSharpness;
+    _RemapCreasesAndCorners([&](int point)
+    {
+        const auto it = std::lower_bound(pointSources.begin(), pointSources.end(), point);
+        return it != pointSources.end() && *it == point ? int(it - pointSources.begin()) : -1;
+    });
+    for (int face : channels.m_holeIndices)
+    {
+        const auto it = std::lower_bound(faces.begin(), faces.end(), face);
+        if (it != faces.end() && *it == face)
+        {
+            m_holeIndices.push_back(int(it - faces.begin()));
+        }
+    }
+
+    // Faces and points map back to those read from the prim
+    m_faceSources.resize(numFaces);
+    for (size_t face = 0; face < numFaces; ++face)
+    {
+        m_faceSources[face] = channels.m_faceSources.empty() ? faces[face] : channels.m_faceSources[faces[face]];
+    }
+    m_pointSources = pointSources;
+    if (!channels.m_pointSources.empty())
+    {
+        for (int &point : m_pointSources)
+        {
+            point = channels.m_pointSources[point];
+        }
+    }
+    SourceRange range;
+    range.label = label;
+    range.firstFace = 0;
+    range.numFaces = numFaces;
+    m_sourceRanges.push_back(range);
+
+    m_faceArity = GeoDataKernels::UniformFaceArity(m_faceCounts.data(), m_faceCounts.size());
+    m_faceSelectionIndices.resize(numFaces);
+    GeoDataKernels::Iota(m_faceSelectionIndices.data(), numFaces);
+    _ComputeTopologyFingerprint();
+    _ComputeUdimTiles();
+}
+
+std::vector<std::shared_ptr<GeoData> > GeoData::Split(size_t maxFaces, size_t maxFaceVertices, const std::string &label)
+{
+    GeoData &channels = _Channels();
+    const size_t numFaces = channels.m_faceCounts.size();
+    if (maxFaces == 0)
+    {
+        maxFaces = numFaces;
+    }
+
+    std::vector<std::shared_ptr<GeoData> > parts;
+    if ((numFaces <= maxFaces && channels.m_vertexIndices.size() <= maxFaceVertices) ||
+        !channels._PointsCoverIndices())
+    {
+        return parts;
+    }
+
+    TRACE_FUNCTION();
+
+    // Whole tiles go in the current part while they fit, a tile too large
+    // for a part of its own is cut along the Morton curve. Without uvs
+    // every face is in the same tile.
+    const std::vector<size_t> faceOffsets = _GetFaceOffsets(channels.m_faceCounts);
+    std::vector<std::pair<uint64_t, int> > keys;
+    channels._SortFacesByTile(faceOffsets, keys);
+
+    std::vector<std::vector<int> > partFaces(1);
+    size_t partFaceVertices = 0;
+    auto fits = [&](size_t faces, size_t faceVertices)
+    {
+        return partFaces.back().empty() ||
+               (partFaces.back().size() + faces <= maxFaces && partFaceVertices + faceVertices <= maxFaceVertices);
+    };
+    for (size_t i = 0; i < numFaces;)
+    {
+        const uint64_t tile = keys[i].first >> 48;
+        size_t tileEnd = i;
+        size_t tileFaceVertices = 0;
+        for (; tileEnd < numFaces && (keys[tileEnd].first >> 48) == tile; ++tileEnd)
+        {
+            tileFaceVertices += size_t(channels.m_faceCounts[keys[tileEnd].second]);
+        }
+        if (!fits(tileEnd - i, tileFaceVertices))
+        {
+            partFaces.emplace_back();
+            partFaceVertices = 0;
+        }
+        for (; i < tileEnd; ++i)
+        {
+            const int face = keys[i].second;
+            const size_t count = size_t(channels.m_faceCounts[face]);
+            if (!fits(1, count))
+            {
+                partFaces.emplace_back();
+                partFaceVertices = 0;
+            }
+            partFaces.back().push_back(face);
+            partFaceVertices += count;
+        }
+    }
+    std::vector<std::pair<uint64_t, int> >().swap(keys);
+
+    // The parts keep the faces in their original order
+    parts.resize(partFaces.size());
+    WorkParallelForN(partFaces.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t part = begin; part < end; ++part)
+        {
+            std::sort(partFaces[part].begin(), partFaces[part].end());
+            parts[part].reset(new GeoData(*this, partFaces[part], faceOffsets, label));
+        }
+    });
+    return parts;
+}
+
+void GeoData::_BuildSmoothGroups(int maxVertexIndex)
+{
+    TRACE_FUNCTION();
+
+    const size_t numFaces = m_faceCounts.size();
+    const size_t numFaceVertices = m_vertexIndices.size();
+    const size_t numPoints = size_t(maxVertexIndex) + 1;
+
+    m_faceOffsets = _GetFaceOffsets(m_faceCounts);
+
+    std::vector<int> faceOf(numFaceVertices);
+    WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+    {
+        for (size_t face = begin; face < end; ++face)
+        {
+            std::fill(faceOf.begin() + m_faceOffsets[face], faceOf.begin() + m_faceOffsets[face + 1], int(face));
+        }
+    });
+
+    // The face vertices of each point as a CSR table, by counting sort
+    std::vector<size_t> pointOffsets(numPoints + 1, 0);
+    for (int index : m_vertexIndices)
+    {
+        ++pointOffsets[index + 1];
+    }
+    std::partial_sum(pointOffsets.begin(), pointOffsets.end(), pointOffsets.begin());
+    std::vector<size_t> pointFaceVertices(numFaceVertices);
+    {
+        std::vector<size_t> cursor(pointOffsets.begin(), pointOffsets.end() - 1);
+        for (size_t faceVertex = 0; faceVertex < numFaceVertices; ++faceVertex)
+        {
+            pointFaceVertices[cursor[m_vertexIndices[faceVertex]]++] = faceVertex;
+        }
+    }
+
+    // Edges of the creases with some sharpness, both ways round, sorted by
+    // their first point. The sharpness is per crease or per crease edge.
+    std::vector<std::pair<int, int> > creasedEdges;
+    {
+        const size_t numCreaseEdges = m_creaseIndices.size() > m_creaseLengths.size() ? m_creaseIndices.size() - m_creaseLengths.size() : 0;
+        const bool perEdgeSharpness = m_creaseSharpness.size() == numCreaseEdges && m_creaseSharpness.size() != m_creaseLengths.size();
+        size_t first = 0;
+        size_t edge = 0;
+        for (size_t crease = 0; crease < m_creaseLengths.size(); ++crease)
+        {
+            const size_t length = size_t(std::max(m_creaseLengths[crease], 0));
+            for (size_t i = 0; i + 1 < length; ++i, ++edge)
+            {
+                const size_t sharpnessIndex = perEdgeSharpness ? edge : crease;
+                if (first + i + 1 >= m_creaseIndices.size() ||
+                    sharpnessIndex >= m_creaseSharpness.size() || m_creaseSharpness[sharpnessIndex] <= 0.0f)
+                {
+                    continue;
+                }
+                const int a = m_creaseIndices[first + i];
+                const int b = m_creaseIndices[first + i + 1];
+                creasedEdges.emplace_back(a, b);
+                creasedEdges.emplace_back(b, a);
+            }
+            first += length;
+        }
+        std::sort(creasedEdges.begin(), creasedEdges.end());
+    }
+
+    // Group the face vertices of each point: faces sharing an edge that is
+    // not creased are in the same group. Each point only writes to its own
+    // face vertices, and to its own range of the CSR table, which then
+    // holds the face vertices of each group in turn.
+    m_normalIndices.resize(numFaceVertices);
+    std::vector<int> numGroups(numPoints + 1, 0);
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end)
+    {
+        std::vector<std::pair<int, int> > neighbours;
+        std::vector<int> parent;
+        std::vector<int> groupOf;
+        for (size_t point = begin; point < end; ++point)
+        {
+            const size_t first = pointOffsets[point];
+            const int count = int(pointOffsets[point + 1] - first);
+            if (count == 0)
+            {
+                continue;
+            }
+
+            auto creases = std::equal_range(creasedEdges.begin(), creasedEdges.end(), std::make_pair(int(point), 0),
+                                            [](const std::pair<int, int> &a, const std::pair<int, int> &b) {return a.first < b.first;});
+            if (creases.first == creases.second)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    m_normalIndices[pointFaceVertices[first + i]] = 0;
+                }
+                numGroups[point + 1] = 1;
+                continue;
+            }
+
+            // The points before and after the point in each of its faces
+            neighbours.clear();
+            parent.resize(count);
+            for (int i = 0; i < count; ++i)
+            {
+                const size_t faceVertex = pointFaceVertices[first + i];
+                const int face = faceOf[faceVertex];
+                const size_t faceFirst = m_faceOffsets[face];
+                const int faceCount = m_faceCounts[face];
+                const int corner = int(faceVertex - faceFirst);
+                neighbours.emplace_back(m_vertexIndices[faceFirst + (corner + faceCount - 1) % faceCount], i);
+                neighbours.emplace_back(m_vertexIndices[faceFirst + (corner + 1) % faceCount], i);
+                parent[i] = i;
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+
+            auto root = [&parent](int i)
+            {
+                while (parent[i] != i)
+                {
+                    i = parent[i] = parent[parent[i]];
+                }
+                return i;
+            };
+            for (size_t i = 1; i < neighbours.size(); ++i)
+            {
+                const int neighbour = neighbours[i].first;
+                if (neighbour == neighbours[i - 1].first &&
+                    !std::binary_search(creases.first, creases.second, std::make_pair(int(point), neighbour)))
+                {
+                    parent[root(neighbours[i].second)] = root(neighbours[i - 1].second);
+                }
+            }
+
+            // Number the groups in order of first face vertex
+            groupOf.assign(count, -1);
+            int groups = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                int &group = groupOf[root(i)];
+                if (group < 0)
+                {
+                    group = groups++;
+                }
+                m_normalIndices[pointFaceVertices[first + i]] = group;
+            }
+            numGroups[point + 1] = groups;
+
+            std::stable_sort(pointFaceVertices.begin() + first, pointFaceVertices.begin() + first + count,
+                             [this](size_t a, size_t b) {return m_normalIndices[a] < m_normalIndices[b];});
+        }
+    });
+    std::partial_sum(numGroups.begin(), numGroups.end(), numGroups.begin());
+
+    m_smoothGroupOffsets.resize(numGroups.back() + 1);
+    m_smoothGroupOffsets.back() = numFaceVertices;
+    m_smoothGroupFaces.resize(numFaceVertices);
+    WorkParallelForN(numPoints, [&](size_t begin, size_t end)
+    {
+        for (size_t point = begin; point < end; ++point)
+        {
+            int previousGroup = -1;
+            for (size_t i = pointOffsets[point]; i < pointOffsets[point + 1]; ++i)
+            {
+                const size_t faceVertex = pointFaceVertices[i];
+                const int group = numGroups[point] + m_normalIndices[faceVertex];
+                if (group != previousGroup)
+                {
+                    m_smoothGroupOffsets[group] = i;
+                    previousGroup = group;
+                }
+                m_normalIndices[faceVertex] = group;
+                m_smoothGroupFaces[i] = faceOf[faceVertex];
+            }
+        }
+    });
+}
+
+void GeoData::_GenerateNormals()
+{
+    TRACE_FUNCTION();
+
+    const GeoData &channels = _Channels();
+    const size_t numFaces = channels.m_faceCounts.size();
+    const size_t numGroups = channels.m_smoothGroupOffsets.size() - 1;
+
+    // Holes do not weigh on the normals around them
+    std::vector<unsigned char> holes(numFaces, 0);
+    for (int face : channels.m_holeIndices)
+    {
+        if (face >= 0 && size_t(face) < numFaces)
+        {
+            holes[face] = 1;
+        }
+    }
+
+    std::vector<float> faceNormals(numFaces * 3);
+    for (const auto &it : m_vertices)
+    {
+        WorkParallelForN(numFaces, [&](size_t begin, size_t end)
+        {
+            GeoDataKernels::FaceNormals(it.second.data(), channels.m_vertexIndices.data(), channels.m_faceOffsets.data(),
+                                        holes.data(), channels.m_leftHanded, begin, end, faceNormals.data());
+        });
+
+        std::vector<float> &normals = m_generatedNormals[it.first];
+        normals.resize(numGroups * 3);
+        WorkParallelForN(numGroups, [&](size_t begin, size_t end)
+        {
+            GeoDataKernels::GatherGroupNormals(faceNormals.data(), channels.m_smoothGroupOffsets.data(),
+                                               channels.m_smoothGroupFaces.data(), begin, end, normals.data());
+        });
+    }
+}
+
+std::string GeoData::GetTopologyFingerprintString()
+{
+    return TfStringPrintf("%016llx", (unsigned long long)GetTopologyFingerprint());
+}
+
+GeoData::~GeoData()
+{
+    Reset();
+}
+
+
+// Print the internal status of the Geometric Data.
+void GeoData::Log(const MriGeoReaderHost& host)
+{
+}
+
+std::string GeoData::GetConsolidationKey()
+{
+    std::string key = TfStringPrintf("%d %d %d %s %d %d %d %d",
+                                     HasNormals(), HasUVs(), IsSubdivMesh(), SubdivisionScheme().c_str(),
+                                     InterpolateBoundary(), FaceVaryingLinearInterpolation(),
+                                     PropagateCorner(), TriangleSubdivision());
+    for (const AdditionalUvSet &uvSet : GetAdditionalUvSets())
+    {
+        key += " " + uvSet.name;
+    }
+    return key;
+}
+
+// Cast to bool. False if no good data is found.
+GeoData::operator bool()
+{
+    return (m_vertices.size() > 0 && m_vertices.begin()->second.size()>0 && _Channels().m_vertexIndices.size()>0);
+}
+
+// Static - Sanity test to see if the usd prim is something we can use.
+bool GeoData::IsValidNode(UsdPrim const &prim, const PathFilter &pathFilter)
+{
+    if (not prim.IsA<UsdGeomMesh>())
+        return false;
+    else
+        return pathFilter.Test(prim.GetPath().GetString());
+}
+
+
+
+// The requested uv sets ("*" for all of them) other than uvSet, once each
+std::vector<std::string> GeoData::GetAdditionalUvSets(UsdPrim const &prim,
+                                                      const std::string &uvSet,
+                                                      const std::vector<std::string> &requested)
+{
+    std::vector<std::string> names;
+    if (std::find(requested.begin(), requested.end(), "*") != requested.end())
+    {
+        UVSet uvs;
+        GetUvSets(prim, uvs);
+        for (const auto &it : uvs)
+        {
+            names.push_back(it.first);
+        }
+    }
+    else
+    {
+        names = requested;
+    }
+    std::vector<std::string> unique;
+    for (const std::string &name : names)
+    {
+        if (name != uvSet && std::find(unique.begin(), unique.end(), name) == unique.end())
+        {
+            unique.push_back(name);
+        }
+    }
+    return unique;
+}
+
+// Pre-scan the UsdStage to see what uv sets are included.
+// Called for many meshes, possibly from several threads at once: it only
+// walks the authored property names, instead of building the primvar vector
+// GetPrimvars() returns, and only makes the primvars that are in the
+// "primvars:" namespace.
+void GeoData::GetUvSets(UsdPrim const &prim, UVSet &retval)
+{
+    UsdGeomGprim   gprim(prim);
+    if (not gprim)
+        return;
+
+    const bool readFloat2AsUV = GeoData::ReadFloat2AsUV();
+    for (const TfToken &propertyName : prim.GetAuthoredPropertyNames())
+    {
+        if (!TfStringStartsWith(propertyName.GetString(), _tokens->primvarsPrefix))
+            continue;
+
+        UsdGeomPrimvar primvar(prim.GetAttribute(propertyName));
+        if (!primvar)
+            continue;
+
+        // Every interpolation the uv sets are expanded from
+        GeoDataKernels::Interpolation interpolation;
+        if (!_GetInterpolation(primvar.GetInterpolation(), interpolation))
+            continue;
+
+        const SdfValueTypeName typeName = primvar.GetTypeName();
+        const std::string &name = primvar.GetPrimvarName().GetString();
+
+        if ((TfStringStartsWith(name, _tokens->uPrefix) || TfStringStartsWith(name, _tokens->vPrefix)) and
+            (typeName == SdfValueTypeNames->FloatArray))
+        {
+            ++retval[name.substr(2)];
+        }
+        else if (typeName == SdfValueTypeNames->TexCoord2fArray ||
+                 (readFloat2AsUV &&
+                  typeName == SdfValueTypeNames->Float2Array))
+        {
+            ++retval[name];
+        }
+    }
+}
+
+float* GeoData::GetNormals(int frameSample)
+{
+    if (m_generatedNormals.empty())
+    {
+        return &(_Channels().m_normals[0]);
+    }
+
+    auto it = m_generatedNormals.find(frameSample);
+    if (it == m_generatedNormals.end())
+    {
+        // Could not find frame -> let's return the first one, as the points do
+        it = m_generatedNormals.begin();
+    }
+    return &(it->second[0]);
+}
+
+size_t GeoData::GetNumNormals()
+{
+    if (m_generatedNormals.empty())
+    {
+        return _Channels().m_normals.size();
+    }
+    return m_generatedNormals.begin()->second.size();
+}
+
+float* GeoData::GetVertices(int frameSample)
+{
+    if (m_vertices.size() > 0)
+    {
+        if (m_vertices.find(frameSample) != m_vertices.end())
+        {
+            return &(m_vertices[frameSample][0]);
+        }
+        else
+        {
+            // Could not find frame -> let's return frame 0
+            return &(m_vertices.begin()->second[0]);
+        }
+    }
+
+    // frame not found.
+    return NULL;
+}
+
+void GeoData::Reset()
+{
+    m_vertexIndices.clear();
+    m_faceCounts.clear();
+    m_faceSelectionIndices.clear();
+
+    m_vertices.clear();
+
+    m_normalIndices.clear();
+    m_normals.clear();
+    m_smoothGroupOffsets.clear();
+    m_smoothGroupFaces.clear();
+    m_faceOffsets.clear();
+    m_generatedNormals.clear();
+    m_pointSources.clear();
+    m_faceSources.clear();
+    m_udimTiles.reset();
+    m_facesOutsideUdims = 0;
+
+    m_uvIndices.clear();
+    m_uvs.clear();
+
+    m_creaseIndices.clear();
+    m_creaseLengths.clear();
+    m_creaseSharpness.clear();
+    m_cornerIndices.clear();
+    m_cornerSharpness.clear();
+    m_holeIndices.clear();
+
+    m_sourceRanges.clear();
+    m_channels.reset();
+}
+
+GeoData::PathFilter::PathFilter()
+{
+}
+
+GeoData::PathFilter::PathFilter(const std::vector<std::string> &require,
+                                const std::vector<std::string> &ignore) :
+    _require(require),
+    _ignore(ignore)
+{
+}
+
+GeoData::PathFilter GeoData::PathFilter::FromEnvironment()
+{
+    std::vector<std::string> require, ignore;
+
+    if (const char *requireEnv = getenv(_requireGeomPathSubstringEnvVar))
+    {
+        require = TfStringTokenize(requireEnv, ",");
+    }
+
+    if (const char *ignoreEnv = getenv(_ignoreGeomPathSubstringEnvVar))
+    {
+        ignore = TfStringTokenize(ignoreEnv, ",");
+    }
+
+    return PathFilter(require, ignore);
+}
+
+bool GeoData::PathFilter::Test(const string &path) const
+{
+    bool requiredSubstringFound = true;
+    std::vector<std::string>::const_iterator i;
+    for (i=_require.begin(); i!=_require.end(); ++i)
+    {
+        if (path.find(*i) != string::npos)
+        {
+            requiredSubstringFound = true;
+            break;
+        } else {
+            requiredSubstringFound = false;
+        }
+    }
+
+    if (requiredSubstringFound == false) 
+    {
+        return false;
+    }
+
+    for (i=_ignore.begin(); i!=_ignore.end(); ++i)
+    {
+        if (path.find(*i) != string::npos)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename SOURCE, typename TYPE>
 bool GeoData::CastVtValueAs(SOURCE &obj, TYPE &result)
 {
@@ -31,6 +31,9 @@
 // language governing permissions and limitations under the Apache License.
 //
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <set>
 #include <vector>
 #include "MriGeoReaderPlugin.h"
@@ -38,6 +41,8 @@
 #include "pxr/usd/usd/prim.h"
 
 #include "MariHostConfig.h"
+#include "GeoDataKernels.h"
+#include "ImportLog.h"
 
 
 class GeoData
@@ -50,34 +55,99 @@ public:
 
         typedef std::map<std::string, int> UVSet;
 
+        // "Required" and "ignore" lists of geometry path substrings, read
+        // from the environment when the filter is made and never changed
+        // after, so one filter can be shared by several threads.
+        class PathFilter
+        {
+        public:
+            PathFilter();
+            PathFilter(const std::vector<std::string> &require,
+                       const std::vector<std::string> &ignore);
+
+            static PathFilter FromEnvironment();
+
+            // Check the geometry path against the two lists
+            bool Test(const std::string &path) const;
+
+        private:
+            std::vector<std::string> _require;
+            std::vector<std::string> _ignore;
+        };
+
         static void GetUvSets(PXR_NS::UsdPrim const &prim, UVSet &retval);
 
-        // Valid nodes are meshes, and subdivs, included in a "Geom" group
-        static bool IsValidNode(PXR_NS::UsdPrim const &prim);
+        // The uv sets to import on top of uvSet: the requested names, or
+        // every uv set of the mesh for "*", leaving uvSet out.
+        static std::vector<std::string> GetAdditionalUvSets(PXR_NS::UsdPrim const &prim,
+                                                            const std::string &uvSet,
+                                                            const std::vector<std::string> &requested);
 
-        // Check the geometry path against a "required" and "ignore" 
-        // list of substrings.
-        static bool TestPath(std::string path);
+        // Valid nodes are meshes, and subdivs, included in a "Geom" group
+        static bool IsValidNode(PXR_NS::UsdPrim const &prim, const PathFilter &pathFilter);
 
         template <typename SOURCE, typename TYPE>
         static bool CastVtValueAs(SOURCE &obj, TYPE &result);
 
-        static void InitializePathSubstringLists();
-
         static bool ReadFloat2AsUV();
 
         // create geoData
         GeoData(PXR_NS::UsdPrim const &prim,
                 std::string uvSet, // requested uvSet
+                const std::vector<std::string> &additionalUvSets, // see GetAdditionalUvSets
                 std::string mappingScheme,
+                bool generateNormals, // smooth normals for meshes without any
+                bool cleanUp, // drop unused points and degenerate faces
+                bool reorderForPainting, // see _ReorderForPainting
                 std::vector<int> frames,
                 bool conformToMariY,
                 bool readerIsUpY,
                 bool keepCentered,
                 PXR_NS::UsdPrim const &model,
                 const MriGeoReaderHost& host,
-                std::vector<std::string>& log);
+                ImportLog& log);
         
+        // A uv set read on top of the requested one. Mari takes a single uv
+        // set per mesh object, so each of them gets a mesh object of its own
+        // sharing every other channel.
+        struct AdditionalUvSet
+        {
+            std::string name;
+            std::vector<float> uvs;
+            // Face varying uv indices, left empty when they are the same as
+            // those of an earlier set: -1 if the set has its own, 0 if they
+            // are the main uv set's, n + 1 if they are additional set n's.
+            std::vector<int> indices;
+            int indicesOf = -1;
+        };
+
+        // One of the meshes a consolidated GeoData was made of, and the
+        // faces it occupies in it.
+        struct SourceRange
+        {
+            std::string label;
+            size_t firstFace;
+            size_t numFaces;
+        };
+
+        // Duplicate of another mesh with the same MeshHash: only the points
+        // are read from the prim and transformed, every other channel is
+        // shared with the original.
+        GeoData(const std::shared_ptr<GeoData> &original,
+                PXR_NS::UsdPrim const &prim,
+                std::vector<int> frames,
+                bool conformToMariY,
+                bool readerIsUpY,
+                bool keepCentered,
+                PXR_NS::UsdPrim const &model,
+                ImportLog& log);
+
+        // Concatenate meshes sharing the same GetConsolidationKey into a
+        // single one, offsetting their indices. The sources are copied in
+        // parallel, and are left untouched.
+        GeoData(const std::vector<GeoData*> &sources,
+                const std::vector<std::string> &labels);
+
         ~GeoData();
      
         // print content
@@ -88,58 +158,192 @@ public:
 
         typedef unsigned* uptr;
 
-        inline uptr GetVertexIndices() {return (unsigned*)&(m_vertexIndices[0]);}
-        inline int GetNumVertexIndices() {return m_vertexIndices.size();}
+        inline uptr GetVertexIndices() {return (unsigned*)&(_Channels().m_vertexIndices[0]);}
+        inline size_t GetNumVertexIndices() {return _Channels().m_vertexIndices.size();}
 
-        inline uptr GetFaceVertexCounts() {return (unsigned*)&(m_faceCounts[0]);}
-        inline int GetNumFaceVertexCounts() {return m_faceCounts.size();}
+        inline uptr GetFaceVertexCounts() {return (unsigned*)&(_Channels().m_faceCounts[0]);}
+        inline size_t GetNumFaceVertexCounts() {return _Channels().m_faceCounts.size();}
+        // Number of vertices of every face, 0 if the faces differ
+        inline int GetFaceArity() {return _Channels().m_faceArity;}
 
-        inline int* GetFaceSelectionIndices() {return &(m_faceSelectionIndices[0]);}
+        inline int* GetFaceSelectionIndices() {return &(_Channels().m_faceSelectionIndices[0]);}
 
         float* GetVertices(int frameSample);
-        inline int GetNumPoints() {return m_vertices.begin()->second.size();}
-
-        inline bool HasNormals() {return (m_normals.size() != 0);}
-        inline uptr GetNormalIndices() {return (unsigned*)&(m_normalIndices[0]);}
-        inline float* GetNormals() {return &(m_normals[0]);}
-        inline int GetNumNormals() {return m_normals.size();}
-
-        inline bool HasUVs() {return (m_uvs.size() != 0);}
-        inline uptr GetUVIndices() {return (unsigned*)&(m_uvIndices[0]);}
-        inline float* GetUVs() {return &(m_uvs[0]);}
-        inline int GetNumUvs() {return m_uvs.size();}
-
-        inline uptr GetCreaseIndices() {return (unsigned*)&(m_creaseIndices[0]);}
-        inline int GetNumCreaseIndices() {return m_creaseIndices.size();}
-
-        inline uptr GetCreaseLengths() {return (unsigned*)&(m_creaseLengths[0]);}
-        inline int GetNumCreaseLengths() {return m_creaseLengths.size();}
-
-        inline float* GetCreaseSharpness() {return &(m_creaseSharpness[0]);}
-        inline int GetNumCreaseSharpness() {return m_creaseSharpness.size();}
-
-        inline uptr GetCornerIndices() {return (unsigned*)&(m_cornerIndices[0]);}
-        inline int GetNumCornerIndices() {return m_cornerIndices.size();}
-
-        inline float* GetCornerSharpness() {return &(m_cornerSharpness[0]);}
-        inline int GetNumCornerSharpness() {return m_cornerSharpness.size();}
-
-        inline uptr GetHoleIndicess() {return (unsigned*)&(m_holeIndices[0]);}
-        inline int GetNumHoleIndices() {return m_holeIndices.size();}
-
-        inline bool IsSubdivMesh() {return m_isSubdivMesh;}
-        inline std::string SubdivisionScheme() {return m_subdivisionScheme;}
-        inline int InterpolateBoundary() {return m_interpolateBoundary;}
-        inline int FaceVaryingLinearInterpolation() {return m_faceVaryingLinearInterpolation;}
-        inline int PropagateCorner() {return m_propagateCorner;}
-        inline int TriangleSubdivision() {return m_triangleSubdivision;}
+        inline size_t GetNumPoints() {return m_vertices.begin()->second.size();}
+
+        // Generated normals follow the points, and change with them from
+        // frame to frame; read normals are the same at every frame.
+        inline bool HasNormals() {return (_Channels().m_normals.size() != 0) || !m_generatedNormals.empty();}
+        inline bool HasGeneratedNormals() const {return !m_generatedNormals.empty();}
+        inline uptr GetNormalIndices() {return (unsigned*)&(_Channels().m_normalIndices[0]);}
+        float* GetNormals(int frameSample);
+        size_t GetNumNormals();
+
+        inline bool HasUVs() {return (_Channels().m_uvs.size() != 0);}
+        inline uptr GetUVIndices() {return (unsigned*)&(_Channels().m_uvIndices[0]);}
+        inline float* GetUVs() {return &(_Channels().m_uvs[0]);}
+        inline size_t GetNumUvs() {return _Channels().m_uvs.size();}
+
+        inline const std::vector<AdditionalUvSet>& GetAdditionalUvSets() {return _Channels().m_additionalUvSets;}
+        // The uv indices of an additional uv set, wherever they are held
+        const std::vector<int>& GetAdditionalUvIndices(size_t set);
+
+        inline uptr GetCreaseIndices() {return (unsigned*)&(_Channels().m_creaseIndices[0]);}
+        inline size_t GetNumCreaseIndices() {return _Channels().m_creaseIndices.size();}
+
+        inline uptr GetCreaseLengths() {return (unsigned*)&(_Channels().m_creaseLengths[0]);}
+        inline size_t GetNumCreaseLengths() {return _Channels().m_creaseLengths.size();}
+
+        inline float* GetCreaseSharpness() {return &(_Channels().m_creaseSharpness[0]);}
+        inline size_t GetNumCreaseSharpness() {return _Channels().m_creaseSharpness.size();}
+
+        inline uptr GetCornerIndices() {return (unsigned*)&(_Channels().m_cornerIndices[0]);}
+        inline size_t GetNumCornerIndices() {return _Channels().m_cornerIndices.size();}
+
+        inline float* GetCornerSharpness() {return &(_Channels().m_cornerSharpness[0]);}
+        inline size_t GetNumCornerSharpness() {return _Channels().m_cornerSharpness.size();}
+
+        inline uptr GetHoleIndicess() {return (unsigned*)&(_Channels().m_holeIndices[0]);}
+        inline size_t GetNumHoleIndices() {return _Channels().m_holeIndices.size();}
+
+        inline bool IsSubdivMesh() {return _Channels().m_isSubdivMesh;}
+        inline std::string SubdivisionScheme() {return _Channels().m_subdivisionScheme;}
+        inline int InterpolateBoundary() {return _Channels().m_interpolateBoundary;}
+        inline int FaceVaryingLinearInterpolation() {return _Channels().m_faceVaryingLinearInterpolation;}
+        inline int PropagateCorner() {return _Channels().m_propagateCorner;}
+        inline int TriangleSubdivision() {return _Channels().m_triangleSubdivision;}
+        inline bool IsLeftHanded() {return _Channels().m_leftHanded;}
+
+        // Meshes can only be consolidated if their keys match: they must
+        // carry the same channels and share their subdivision settings.
+        std::string GetConsolidationKey();
+
+        // True for a duplicate sharing the channels of another mesh
+        inline bool SharesChannels() const {return m_channels != nullptr;}
+
+        // Hash of the face vertex counts, vertex indices and uv indices, as
+        // handed to Mari: meshes with the same fingerprint can be versions
+        // of one another, whatever their points and uvs. Computed when the
+        // mesh is read, shared by duplicates.
+        inline uint64_t GetTopologyFingerprint() {return _Channels().m_topologyFingerprint;}
+        std::string GetTopologyFingerprintString();
+
+        // The face each face was read as, when they were removed or
+        // reordered, empty otherwise. Ptex faces and face selections made
+        // on the import map back to the USD mesh through it.
+        inline const std::vector<int>& GetFaceSources() {return _Channels().m_faceSources;}
+
+        // What cleaning up the mesh took out of it, shared by duplicates
+        inline size_t GetNumRemovedPoints() {return _Channels().m_removedPoints;}
+        inline size_t GetNumRemovedFaces() {return _Channels().m_removedFaces;}
+
+        // The UDIM tiles the faces of the uv set occupy, and the number of
+        // faces outside of them, shared by duplicates. Empty without uvs.
+        inline const GeoDataKernels::UdimTiles& GetUdimTiles() {return _Channels().m_udimTiles;}
+        inline size_t GetNumFacesOutsideUdims() {return _Channels().m_facesOutsideUdims;}
+
+        // Empty unless this mesh was consolidated from several others, or
+        // split from a larger one
+        inline const std::vector<SourceRange>& GetSourceRanges() const {return m_sourceRanges;}
+
+        // Parts of at most maxFaces faces (no limit if 0) and maxFaceVertices
+        // face vertices, made of whole uv tiles when they fit, and of faces
+        // close together along a Morton curve otherwise. Empty if the mesh
+        // fits. Each part holds the points, uvs and normals it uses, and
+        // the creases whose points are all in it; its faces map back to
+        // this mesh's through GetFaceSources, under a single SourceRange
+        // named label.
+        std::vector<std::shared_ptr<GeoData> > Split(size_t maxFaces, size_t maxFaceVertices, const std::string &label);
 
         // is valid?
         operator bool();
 
+        // Why the mesh could not be read, empty if it was.
+        inline const std::string& GetRejectReason() const {return m_rejectReason;}
+
 protected:
+        enum class UvSetStatus {Read, NotFound, Unsupported, Unreadable, Mismatch};
+
+        // Reads a uv set and expands it to face varying indices. A uv set
+        // stored as u_<name> and v_<name> float primvars is interleaved.
+        UvSetStatus _ReadUvSet(PXR_NS::UsdPrim const &prim,
+                               const std::string &name,
+                               bool isTopologyVarying,
+                               int maxVertexIndex,
+                               std::vector<float> &uvs,
+                               std::vector<int> &uvIndices);
+
+        // Points the additional uv set at the first earlier set with the
+        // same uv indices, if any, and drops its own copy of them
+        void _ShareUvIndices(AdditionalUvSet &uvSet);
+
+        // Reads the points at each frame, transformed to world space (or to
+        // the model's space if keepCentered)
+        bool _ReadPoints(PXR_NS::UsdPrim const &prim,
+                         const std::vector<int> &frames,
+                         bool conformToMariY,
+                         bool readerIsUpY,
+                         bool keepCentered,
+                         PXR_NS::UsdPrim const &model,
+                         ImportLog& log);
+
+        void _ComputeTopologyFingerprint();
+        void _ComputeUdimTiles();
+
+        // True if every frame has the points the faces use
+        bool _PointsCoverIndices() const;
+
+        // Drops the faces with fewer than three distinct points or no area
+        // at any frame, then the points no face uses, renumbering the
+        // indices that refer to either
+        void _CleanUp(PXR_NS::UsdPrim const &prim, ImportLog& log);
+
+        // Sorts the faces by uv tile, then along a Morton curve through
+        // their centres at the first frame, and numbers the points in order
+        // of first use, so that neighbouring faces and their points are
+        // close together in memory
+        void _ReorderForPainting();
+
+        // The faces of source listed in faces, in ascending order, as a
+        // mesh of their own; see Split
+        GeoData(GeoData &source,
+                const std::vector<int> &faces,
+                const std::vector<size_t> &faceOffsets,
+                const std::string &label);
+
+        // Face centres sorted into keys of their uv tile (top 16 bits) and
+        // position along a Morton curve at the first frame, paired with
+        // the face
+        void _SortFacesByTile(const std::vector<size_t> &faceOffsets, std::vector<std::pair<uint64_t, int> > &keys);
+
+        // Replaces the faces by faceSources[i] for each new face i, and
+        // point p by pointRemap[p] in the indices, or drops what uses it
+        // if that is -1. The points themselves are left to _GatherPoints.
+        void _RemapFaces(const std::vector<int> &faceSources, const std::vector<int> &pointRemap);
+
+        // Replaces the points by pointSources[i] for each new point i, at
+        // every frame
+        bool _GatherPoints(const std::vector<int> &pointSources);
+
+        // Renumbers the points of the creases and corners, dropping those
+        // on a point remapped to -1
+        void _RemapCreasesAndCorners(const std::function<int(int)> &pointRemap);
+
+        // Splits the faces around each point into smooth groups, which
+        // creased edges separate, and points the face vertices at the
+        // normal of their group. Built once per topology.
+        void _BuildSmoothGroups(int maxVertexIndex);
+
+        // One area weighted normal per smooth group at each frame, from
+        // this mesh's own points
+        void _GenerateNormals();
+
+        // The mesh holding every channel but the points
+        inline GeoData& _Channels() {return m_channels ? *m_channels : *this;}
+
         std::vector<int> m_vertexIndices;
         std::vector<int> m_faceCounts;
+        int m_faceArity = 0;
         std::vector<int> m_faceSelectionIndices;
 
         std::map<int, std::vector<float> > m_vertices;
@@ -147,9 +351,20 @@ protected:
         std::vector<int> m_normalIndices;
         std::vector<float> m_normals;
 
+        // Faces of each smooth group as a CSR table, and the first face
+        // vertex of each face, when normals are generated
+        std::vector<size_t> m_smoothGroupOffsets;
+        std::vector<int> m_smoothGroupFaces;
+        std::vector<size_t> m_faceOffsets;
+        // Orientation of the mesh, which generated normals follow
+        bool m_leftHanded = false;
+        std::map<int, std::vector<float> > m_generatedNormals;
+
         std::vector<int> m_uvIndices;
         std::vector<float> m_uvs;
 
+        std::vector<AdditionalUvSet> m_additionalUvSets;
+
         std::vector<int> m_creaseIndices;
         std::vector<int> m_creaseLengths;
         std::vector<float> m_creaseSharpness;
@@ -164,10 +379,23 @@ protected:
         int m_propagateCorner;
         int m_triangleSubdivision;
 
-        static std::string _requireGeomPathSubstringEnvVar;
-        static std::string _ignoreGeomPathSubstringEnvVar;
-        static std::vector<std::string> _requireGeomPathSubstring;
-        static std::vector<std::string> _ignoreGeomPathSubstring;
+        std::string m_rejectReason;
+
+        std::vector<SourceRange> m_sourceRanges;
+
+        uint64_t m_topologyFingerprint = 0;
+
+        GeoDataKernels::UdimTiles m_udimTiles;
+        size_t m_facesOutsideUdims = 0;
+
+        // The point and face each point and face was read as, after
+        // _CleanUp and _ReorderForPainting, empty if they were left alone
+        std::vector<int> m_pointSources;
+        std::vector<int> m_faceSources;
+        size_t m_removedPoints = 0;
+        size_t m_removedFaces = 0;
+
+        std::shared_ptr<GeoData> m_channels;
 };
 
 #endif //GEO_DATA_H
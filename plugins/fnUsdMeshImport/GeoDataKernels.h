@@ -0,0 +1,615 @@
+#ifndef GEO_DATA_KERNELS_H
+#define GEO_DATA_KERNELS_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Inner loops used by GeoData to convert USD arrays into the buffers handed to
+// Mari. They only depend on the standard library so that they can be measured
+// in isolation (see bench/geoDataKernelsBench.cpp). All of them write into
+// pre-sized output buffers; none of them allocate.
+namespace GeoDataKernels
+{
+    // out[i] = perVertex[vertexIndices[i]]
+    // Expands a vertex interpolated index table into a face varying one: one
+    // entry per face-vertex, looked up through the face-vertex's point index.
+    inline void ExpandVertexToFaceVarying(const int *vertexIndices,
+                                          size_t numFaceVertices,
+                                          const int *perVertex,
+                                          int *out)
+    {
+        for (size_t i = 0; i < numFaceVertices; ++i)
+        {
+            out[i] = perVertex[vertexIndices[i]];
+        }
+    }
+
+    // Interpolation of a primvar over a mesh
+    enum class Interpolation
+    {
+        Constant,       // one element for the whole mesh
+        Uniform,        // one element per face
+        Vertex,         // one element per point
+        Varying,        // one element per point, same as Vertex on a mesh
+        FaceVarying     // one element per face-vertex
+    };
+
+    // out[i] = index into a primvar's values of face-vertex i, i.e. the face
+    // varying index table the host takes for every primvar. Face-vertex i
+    // maps to element 0 (constant), to its face (uniform), to its point
+    // (vertex, varying) or to i (faceVarying); indexed primvars then look
+    // the element up in primvarIndices. Every combination compiles down to a
+    // single fill, copy or gather loop. Uniform expects the face counts to
+    // add up to numFaceVertices; given a non-zero Arity, it assumes every
+    // face has that many vertices and ignores faceCounts, so that the inner
+    // loop has a fixed trip count the compiler can unroll.
+    template <Interpolation I, bool Indexed, int Arity = 0>
+    inline void ExpandToFaceVarying(const int *faceCounts,
+                                    size_t numFaces,
+                                    const int *vertexIndices,
+                                    size_t numFaceVertices,
+                                    const int *primvarIndices,
+                                    int *out)
+    {
+        if constexpr (I == Interpolation::Constant)
+        {
+            const int value = Indexed ? primvarIndices[0] : 0;
+            for (size_t i = 0; i < numFaceVertices; ++i)
+            {
+                out[i] = value;
+            }
+        }
+        else if constexpr (I == Interpolation::Uniform && Arity > 0)
+        {
+            for (size_t face = 0; face < numFaces; ++face)
+            {
+                const int value = Indexed ? primvarIndices[face] : int(face);
+                for (int j = 0; j < Arity; ++j)
+                {
+                    out[face * Arity + j] = value;
+                }
+            }
+        }
+        else if constexpr (I == Interpolation::Uniform)
+        {
+            for (size_t face = 0; face < numFaces; ++face)
+            {
+                const int value = Indexed ? primvarIndices[face] : int(face);
+                const int count = faceCounts[face];
+                for (int j = 0; j < count; ++j)
+                {
+                    out[j] = value;
+                }
+                out += count;
+            }
+        }
+        else if constexpr (I == Interpolation::Vertex || I == Interpolation::Varying)
+        {
+            if constexpr (Indexed)
+            {
+                ExpandVertexToFaceVarying(vertexIndices, numFaceVertices, primvarIndices, out);
+            }
+            else if (numFaceVertices > 0)
+            {
+                memcpy(out, vertexIndices, numFaceVertices * sizeof(int));
+            }
+        }
+        else
+        {
+            if constexpr (Indexed)
+            {
+                if (numFaceVertices > 0)
+                {
+                    memcpy(out, primvarIndices, numFaceVertices * sizeof(int));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < numFaceVertices; ++i)
+                {
+                    out[i] = int(i);
+                }
+            }
+        }
+    }
+
+    // True if every index is in [0, size). Checks the whole array without
+    // branching, so that the loop vectorises.
+    inline bool IndicesInRange(const int *indices, size_t count, size_t size)
+    {
+        unsigned outOfRange = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            outOfRange |= unsigned(size_t(unsigned(indices[i])) >= size);
+        }
+        return outOfRange == 0;
+    }
+
+    // The number of vertices of every face if they all have the same, 0 if
+    // they do not or there are no faces.
+    inline int UniformFaceArity(const int *faceCounts, size_t numFaces)
+    {
+        if (numFaces == 0)
+        {
+            return 0;
+        }
+        const int first = faceCounts[0];
+        int differ = 0;
+        for (size_t i = 1; i < numFaces; ++i)
+        {
+            differ |= faceCounts[i] ^ first;
+        }
+        return differ == 0 ? first : 0;
+    }
+
+    // Sum of the array, 0 if empty.
+    inline size_t Sum(const int *values, size_t count)
+    {
+        size_t sum = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            sum += size_t(values[i]);
+        }
+        return sum;
+    }
+
+    // Largest index in the array, 0 if empty.
+    inline int MaxIndex(const int *indices, size_t count)
+    {
+        int maxIndex = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            maxIndex = indices[i] > maxIndex ? indices[i] : maxIndex;
+        }
+        return maxIndex;
+    }
+
+    // out[i] = in[i] + offset
+    // Rebases an index table when meshes are concatenated.
+    inline void OffsetIndices(const int *in, size_t count, int offset, int *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = in[i] + offset;
+        }
+    }
+
+    // out[i] = first + i
+    inline void Iota(int *out, size_t count, int first = 0)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = first + int(i);
+        }
+    }
+
+    // Transforms xyz triplets in place by a row-major 4x4 matrix, treating
+    // each point as the row vector (x, y, z, 1) - the same as GfVec4d *
+    // GfMatrix4d, evaluated in double precision.
+    inline void TransformPoints(float *points, size_t numPoints, const double *m)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            float *p = points + i * 3;
+            const double x = p[0];
+            const double y = p[1];
+            const double z = p[2];
+            p[0] = float(x * m[0] + y * m[4] + z * m[8]  + m[12]);
+            p[1] = float(x * m[1] + y * m[5] + z * m[9]  + m[13]);
+            p[2] = float(x * m[2] + y * m[6] + z * m[10] + m[14]);
+        }
+    }
+
+    // out[2i] = u[i], out[2i + 1] = v[i]
+    // Builds a float2 uv buffer from split u and v components.
+    inline void InterleaveUVs(const float *u, const float *v, size_t count, float *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[2 * i] = u[i];
+            out[2 * i + 1] = v[i];
+        }
+    }
+
+    // out[2i] = u[uIndices[i]], out[2i + 1] = v[vIndices[i]]
+    // Same as InterleaveUVs for components indexed differently: one uv per
+    // face-vertex, looked up through each component's own indices.
+    inline void GatherInterleaveUVs(const float *u, const int *uIndices,
+                                    const float *v, const int *vIndices,
+                                    size_t count, float *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[2 * i] = u[uIndices[i]];
+            out[2 * i + 1] = v[vIndices[i]];
+        }
+    }
+
+    // Area weighted normals of faces [faceBegin, faceEnd): the vector area
+    // of each polygon by Newell's method, which also copes with non-planar
+    // and concave faces. faceOffsets[f] is the first face-vertex of face f,
+    // with one extra entry at the end. Faces with a non-zero skip[f], if
+    // skip is given, get a null normal. Left handed faces are negated.
+    template <typename Offset>
+    inline void FaceNormals(const float *points,
+                            const int *vertexIndices,
+                            const Offset *faceOffsets,
+                            const unsigned char *skip,
+                            bool leftHanded,
+                            size_t faceBegin,
+                            size_t faceEnd,
+                            float *out)
+    {
+        const float sign = leftHanded ? -0.5f : 0.5f;
+        for (size_t face = faceBegin; face < faceEnd; ++face)
+        {
+            float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+            const Offset begin = faceOffsets[face];
+            const Offset end = faceOffsets[face + 1];
+            if (!(skip && skip[face]) && end - begin >= 3)
+            {
+                const float *prev = points + 3 * vertexIndices[end - 1];
+                for (Offset i = begin; i < end; ++i)
+                {
+                    const float *p = points + 3 * vertexIndices[i];
+                    nx += (prev[1] - p[1]) * (prev[2] + p[2]);
+                    ny += (prev[2] - p[2]) * (prev[0] + p[0]);
+                    nz += (prev[0] - p[0]) * (prev[1] + p[1]);
+                    prev = p;
+                }
+            }
+            out[3 * face] = nx * sign;
+            out[3 * face + 1] = ny * sign;
+            out[3 * face + 2] = nz * sign;
+        }
+    }
+
+    // Centre of each face of [faceBegin, faceEnd): the mean of the
+    // values, of the given number of components, that the face indexes.
+    // Used with points, or with uvs and their face varying indices.
+    template <typename Offset>
+    inline void FaceCentres(const float *values,
+                            int components,
+                            const int *indices,
+                            const Offset *faceOffsets,
+                            size_t faceBegin,
+                            size_t faceEnd,
+                            float *out)
+    {
+        for (size_t face = faceBegin; face < faceEnd; ++face)
+        {
+            const Offset begin = faceOffsets[face];
+            const Offset end = faceOffsets[face + 1];
+            float *centre = out + components * face;
+            for (int c = 0; c < components; ++c)
+            {
+                centre[c] = 0.0f;
+            }
+            for (Offset i = begin; i < end; ++i)
+            {
+                const float *value = values + components * indices[i];
+                for (int c = 0; c < components; ++c)
+                {
+                    centre[c] += value[c];
+                }
+            }
+            if (end > begin)
+            {
+                const float scale = 1.0f / float(end - begin);
+                for (int c = 0; c < components; ++c)
+                {
+                    centre[c] *= scale;
+                }
+            }
+        }
+    }
+
+    // Spreads the low 16 bits of x two bits apart
+    inline uint64_t SpreadBits3(uint64_t x)
+    {
+        x &= 0xffff;
+        x = (x | (x << 16)) & 0x0000ff0000ffull;
+        x = (x | (x << 8)) & 0x00f00f00f00full;
+        x = (x | (x << 4)) & 0x0c30c30c30c3ull;
+        x = (x | (x << 2)) & 0x249249249249ull;
+        return x;
+    }
+
+    // 48 bit Morton code of a cell of a 65536^3 grid: sorting by it walks
+    // the cells along a Z-order curve, which keeps neighbours close.
+    inline uint64_t Morton48(unsigned x, unsigned y, unsigned z)
+    {
+        return SpreadBits3(x) | (SpreadBits3(y) << 1) | (SpreadBits3(z) << 2);
+    }
+
+    // UDIM tiles: unit squares of uv space 10 columns wide, tile i being
+    // UDIM 1001 + i, over the rows Mari addresses
+    const int kUdimColumns = 10;
+    const int kUdimRows = 100;
+    typedef std::bitset<kUdimColumns * kUdimRows> UdimTiles;
+
+    // Sets the tile of the uv centre of each face of [faceBegin, faceEnd)
+    // and returns the number of faces centred outside of the tiles. Centres
+    // rather than uvs, so that a face with uvs on the edge of its tile does
+    // not mark the next one.
+    template <typename Offset>
+    inline size_t MarkUdimTiles(const float *uvs,
+                                const int *uvIndices,
+                                const Offset *faceOffsets,
+                                size_t faceBegin,
+                                size_t faceEnd,
+                                UdimTiles &tiles)
+    {
+        size_t outside = 0;
+        for (size_t face = faceBegin; face < faceEnd; ++face)
+        {
+            const Offset begin = faceOffsets[face];
+            const Offset end = faceOffsets[face + 1];
+            if (end == begin)
+            {
+                continue;
+            }
+            float u = 0.0f, v = 0.0f;
+            for (Offset i = begin; i < end; ++i)
+            {
+                u += uvs[2 * uvIndices[i]];
+                v += uvs[2 * uvIndices[i] + 1];
+            }
+            const float column = std::floor(u / float(end - begin));
+            const float row = std::floor(v / float(end - begin));
+            if (column >= 0.0f && column < float(kUdimColumns) && row >= 0.0f && row < float(kUdimRows))
+            {
+                tiles.set(size_t(column) + kUdimColumns * size_t(row));
+            }
+            else
+            {
+                ++outside;
+            }
+        }
+        return outside;
+    }
+
+    // Clears zeroArea[f] for the faces of [faceBegin, faceEnd) that have an
+    // area at these points, leaving it as it was for the others: called for
+    // each frame in turn, what is left set has no area at any of them. The
+    // area is compared to the sum of the squared edge lengths, so that the
+    // rounding of collinear points does not count as area.
+    template <typename Offset>
+    inline void ClearFacesWithArea(const float *points,
+                                   const int *vertexIndices,
+                                   const Offset *faceOffsets,
+                                   size_t faceBegin,
+                                   size_t faceEnd,
+                                   unsigned char *zeroArea)
+    {
+        for (size_t face = faceBegin; face < faceEnd; ++face)
+        {
+            const Offset begin = faceOffsets[face];
+            const Offset end = faceOffsets[face + 1];
+            if (!zeroArea[face] || end - begin < 3)
+            {
+                continue;
+            }
+            float nx = 0.0f, ny = 0.0f, nz = 0.0f, edges = 0.0f;
+            const float *prev = points + 3 * vertexIndices[end - 1];
+            for (Offset i = begin; i < end; ++i)
+            {
+                const float *p = points + 3 * vertexIndices[i];
+                nx += (prev[1] - p[1]) * (prev[2] + p[2]);
+                ny += (prev[2] - p[2]) * (prev[0] + p[0]);
+                nz += (prev[0] - p[0]) * (prev[1] + p[1]);
+                const float dx = p[0] - prev[0], dy = p[1] - prev[1], dz = p[2] - prev[2];
+                edges += dx * dx + dy * dy + dz * dz;
+                prev = p;
+            }
+            const float tolerance = 1e-6f * edges;
+            if (nx * nx + ny * ny + nz * nz > tolerance * tolerance)
+            {
+                zeroArea[face] = 0;
+            }
+        }
+    }
+
+    // Normalised sum of the normals of the faces of each of the groups
+    // [groupBegin, groupEnd), laid out as a CSR table: the faces of group g
+    // are groupFaces[groupOffsets[g]] to groupFaces[groupOffsets[g + 1] - 1].
+    // Every group only reads, so groups can be split across threads freely.
+    // A group whose faces add up to nothing gets (0, 1, 0).
+    template <typename Offset>
+    inline void GatherGroupNormals(const float *faceNormals,
+                                   const Offset *groupOffsets,
+                                   const int *groupFaces,
+                                   size_t groupBegin,
+                                   size_t groupEnd,
+                                   float *out)
+    {
+        for (size_t group = groupBegin; group < groupEnd; ++group)
+        {
+            double nx = 0.0, ny = 0.0, nz = 0.0;
+            for (Offset i = groupOffsets[group]; i < groupOffsets[group + 1]; ++i)
+            {
+                const float *n = faceNormals + 3 * groupFaces[i];
+                nx += n[0];
+                ny += n[1];
+                nz += n[2];
+            }
+            const double length = std::sqrt(nx * nx + ny * ny + nz * nz);
+            if (length > 0.0)
+            {
+                out[3 * group] = float(nx / length);
+                out[3 * group + 1] = float(ny / length);
+                out[3 * group + 2] = float(nz / length);
+            }
+            else
+            {
+                out[3 * group] = 0.0f;
+                out[3 * group + 1] = 1.0f;
+                out[3 * group + 2] = 0.0f;
+            }
+        }
+    }
+
+    // Z-up to Y-up: (x, y, z) -> (x, z, -y), in place.
+    inline void SwizzleZUpToYUp(float *points, size_t numPoints)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            float *p = points + i * 3;
+            const float y = p[1];
+            p[1] = p[2];
+            p[2] = -y;
+        }
+    }
+
+    // Copies an array of fixed-size float tuples (GfVec2f, GfVec3f...) into a
+    // flat float buffer.
+    template <size_t N, typename T>
+    inline void FlattenTuples(const T *src, size_t count, float *dst)
+    {
+        static_assert(sizeof(T) == N * sizeof(float), "tuple type must be N tightly packed floats");
+        if (count > 0)
+        {
+            memcpy(dst, src, count * sizeof(T));
+        }
+    }
+
+    // 64 bit hash of a buffer, following xxHash64: the bulk of the buffer is
+    // consumed 32 bytes at a time by four independent accumulators, which
+    // the compiler can keep in registers and interleave. Chain calls through
+    // the seed to hash several buffers.
+    namespace Hash64Detail
+    {
+        const uint64_t kPrime1 = 11400714785074694791ULL;
+        const uint64_t kPrime2 = 14029467366897019727ULL;
+        const uint64_t kPrime3 = 1609587929392839161ULL;
+        const uint64_t kPrime4 = 9650029242287828579ULL;
+        const uint64_t kPrime5 = 2870177450012600261ULL;
+
+        inline uint64_t Rotl(uint64_t x, int r) {return (x << r) | (x >> (64 - r));}
+
+        inline uint64_t Read64(const unsigned char *p)
+        {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint32_t Read32(const unsigned char *p)
+        {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t Round(uint64_t acc, uint64_t input)
+        {
+            acc += input * kPrime2;
+            acc = Rotl(acc, 31);
+            return acc * kPrime1;
+        }
+
+        inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+        {
+            acc ^= Round(0, value);
+            return acc * kPrime1 + kPrime4;
+        }
+    }
+
+    inline uint64_t Hash64(const void *data, size_t size, uint64_t seed)
+    {
+        using namespace Hash64Detail;
+
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        const unsigned char *end = p + size;
+        uint64_t h;
+
+        if (size >= 32)
+        {
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            const unsigned char *limit = end - 32;
+            do
+            {
+                v1 = Round(v1, Read64(p));
+                v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16));
+                v4 = Round(v4, Read64(p + 24));
+                p += 32;
+            }
+            while (p <= limit);
+
+            h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            h = MergeRound(h, v1);
+            h = MergeRound(h, v2);
+            h = MergeRound(h, v3);
+            h = MergeRound(h, v4);
+        }
+        else
+        {
+            h = seed + kPrime5;
+        }
+
+        h += uint64_t(size);
+
+        for (; p + 8 <= end; p += 8)
+        {
+            h ^= Round(0, Read64(p));
+            h = Rotl(h, 27) * kPrime1 + kPrime4;
+        }
+        if (p + 4 <= end)
+        {
+            h ^= uint64_t(Read32(p)) * kPrime1;
+            h = Rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            h ^= uint64_t(*p) * kPrime5;
+            h = Rotl(h, 11) * kPrime1;
+        }
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+}
+
+#endif //GEO_DATA_KERNELS_H
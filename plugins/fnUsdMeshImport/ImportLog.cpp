@@ -0,0 +1,205 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "ImportLog.h"
+
+#include "pxr/base/tf/envSetting.h"
+#include "pxr/base/tf/stringUtils.h"
+
+#include <cstdarg>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_ENV_SETTING(MARI_USD_LOG_LEVEL, 2,
+        "Verbosity of the USD importer: 0 errors, 1 warnings, 2 info, 3 debug. "
+        "Levels above MARI_USD_LOG_MAX_LEVEL are compiled out.");
+
+const size_t ImportLog::kMaxMessages = 200;
+
+//------------------------------------------------------------------------------
+// ImportLog implementation
+//------------------------------------------------------------------------------
+
+ImportLog::ImportLog(const MriGeoReaderHost &host, const char *name, bool quiet) :
+    _host(host),
+    _name(name),
+    _level(quiet ? -1 : TfGetEnvSetting(MARI_USD_LOG_LEVEL)),
+    _parent(nullptr),
+    _warningCount(0),
+    _droppedWarnings(0)
+{
+}
+
+ImportLog::ImportLog(ImportLog &parent) :
+    _host(parent._host),
+    _name(parent._name),
+    _level(parent._level),
+    _parent(&parent),
+    _warningCount(0),
+    _droppedWarnings(0)
+{
+}
+
+ImportLog::~ImportLog()
+{
+    FlushTraces();
+}
+
+void
+ImportLog::Write(Level level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const string message = TfVStringPrintf(format, args);
+    va_end(args);
+
+    _Write(level, message);
+}
+
+void
+ImportLog::_Write(Level level, const string &message)
+{
+    if (_parent)
+    {
+        if (level <= Warning)
+        {
+            lock_guard<mutex> lock(_mutex);
+            _messages.push_back(message);
+        }
+        if (_parent->IsEnabled(level))
+            _parent->_Write(level, message);
+        else
+            _parent->Drop(level);
+        return;
+    }
+
+    lock_guard<mutex> lock(_mutex);
+    // Errors are few and always kept, they are what the user must see
+    if (level == Error)
+    {
+        _messages.push_back(message);
+    }
+    else if (level == Warning)
+    {
+        // IsEnabled may have let a few more in from other threads
+        if (_warningCount.load(std::memory_order_relaxed) < kMaxMessages)
+        {
+            _messages.push_back(message);
+            ++_warningCount;
+        }
+        else
+            ++_droppedWarnings;
+    }
+
+    // Warnings are per mesh, only the user messages get them
+    if (level != Warning)
+        _traces.push_back(message);
+}
+
+void
+ImportLog::Drop(Level level)
+{
+    if (level != Warning || level > _level)
+        return;
+
+    if (_parent)
+        _parent->Drop(level);
+    else
+        ++_droppedWarnings;
+}
+
+void
+ImportLog::FlushTraces()
+{
+    vector<string> traces;
+    {
+        lock_guard<mutex> lock(_mutex);
+        traces.swap(_traces);
+    }
+    for (const string &trace : traces)
+    {
+        _host.trace("[%s] %s", _name, trace.c_str());
+    }
+}
+
+void
+ImportLog::Count(const string &what, const string &detail)
+{
+    if (_parent)
+    {
+        _parent->Count(what, detail);
+        return;
+    }
+
+    lock_guard<mutex> lock(_mutex);
+    ++_counts[make_pair(what, detail)];
+}
+
+void
+ImportLog::TraceCounts() const
+{
+    if (_level < Info)
+        return;
+
+    lock_guard<mutex> lock(_mutex);
+    for (const auto &it : _counts)
+    {
+        _host.trace("[%s] %zu %s: %s", _name, it.second, it.first.first.c_str(), it.first.second.c_str());
+    }
+}
+
+vector<string>
+ImportLog::GetMessages(size_t first) const
+{
+    lock_guard<mutex> lock(_mutex);
+    if (first >= _messages.size())
+        return vector<string>();
+    return vector<string>(_messages.begin() + first, _messages.end());
+}
+
+string
+ImportLog::GetText() const
+{
+    lock_guard<mutex> lock(_mutex);
+
+    string text = TfStringJoin(_messages, "\n");
+    const size_t droppedWarnings = _droppedWarnings.load();
+    if (droppedWarnings > 0)
+    {
+        text += TfStringPrintf("%s%zu more warnings not shown", text.empty() ? "" : "\n", droppedWarnings);
+    }
+    for (const auto &it : _counts)
+    {
+        text += TfStringPrintf("%s%zu %s: %s", text.empty() ? "" : "\n",
+                               it.second, it.first.first.c_str(), it.first.second.c_str());
+    }
+    return text;
+}
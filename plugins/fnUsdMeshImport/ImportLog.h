@@ -0,0 +1,151 @@
+#ifndef IMPORT_LOG_H
+#define IMPORT_LOG_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "MriGeoReaderPlugin.h"
+#include "pxr/base/arch/attributes.h"
+
+#include "MariHostConfig.h"
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Most verbose level compiled in. Messages above it are removed entirely,
+/// arguments included. Defaults to Info in release builds, Debug otherwise.
+#ifndef MARI_USD_LOG_MAX_LEVEL
+#  ifdef NDEBUG
+#    define MARI_USD_LOG_MAX_LEVEL 2
+#  else
+#    define MARI_USD_LOG_MAX_LEVEL 3
+#  endif
+#endif
+
+/// Logs a printf style message. The arguments are only evaluated, and the
+/// message only formatted, when the level is enabled; warnings over the
+/// limit are only counted.
+#define MARI_USD_LOG(log, level, ...)   do { \
+                                            if ((level) <= MARI_USD_LOG_MAX_LEVEL) \
+                                            { \
+                                                if ((log).IsEnabled(level)) \
+                                                    (log).Write(level, __VA_ARGS__); \
+                                                else \
+                                                    (log).Drop(level); \
+                                            } \
+                                        } while (0)
+
+#define MARI_USD_LOG_ERROR(log, ...)    MARI_USD_LOG(log, ImportLog::Error, __VA_ARGS__)
+#define MARI_USD_LOG_WARNING(log, ...)  MARI_USD_LOG(log, ImportLog::Warning, __VA_ARGS__)
+#define MARI_USD_LOG_INFO(log, ...)     MARI_USD_LOG(log, ImportLog::Info, __VA_ARGS__)
+#define MARI_USD_LOG_DEBUG(log, ...)    MARI_USD_LOG(log, ImportLog::Debug, __VA_ARGS__)
+
+class ImportLog
+{
+    // Log of one import. Errors and the first kMaxMessages warnings are kept
+    // as the messages shown to the user once the import is done, the other
+    // warnings are only counted; errors, info and debug messages
+    // are traced through the host. Repeated events are counted with Count()
+    // and reported once, e.g. "1234 meshes discarded: uv set not found".
+    // All methods are thread safe, except that the host is only called by
+    // FlushTraces, TraceCounts and the destructor, on the thread the host
+    // called the plug-in on: messages written from worker threads are held
+    // until then.
+public:
+    enum Level
+    {
+        Error = 0,
+        Warning = 1,
+        Info = 2,
+        Debug = 3
+    };
+
+    // A quiet log writes nothing, for work done again later with a log
+    // that does
+    ImportLog(const MriGeoReaderHost &host, const char *name, bool quiet = false);
+
+    // Log of one mesh of the import of parent, for the import report: it
+    // keeps every error and warning written to it, with no limit, and
+    // passes everything on to parent
+    explicit ImportLog(ImportLog &parent);
+
+    ~ImportLog();
+
+    // Runtime level, from MARI_USD_LOG_LEVEL. Warnings are also disabled
+    // once the warning limit is reached, and only counted from then on.
+    inline bool IsEnabled(Level level) const
+    {
+        return level <= _level &&
+               (level != Warning || _parent || _warningCount.load(std::memory_order_relaxed) < kMaxMessages);
+    }
+
+    void Write(Level level, const char *format, ...) ARCH_PRINTF_FUNCTION(3, 4);
+
+    // Counts a message IsEnabled turned down because of the warning limit
+    void Drop(Level level);
+
+    // Counts one occurrence of an event, reported as "<count> <what>: <detail>"
+    void Count(const std::string &what, const std::string &detail);
+
+    // Traces the messages written since the last call
+    void FlushTraces();
+
+    // Traces the counted events
+    void TraceCounts() const;
+
+    std::vector<std::string> GetMessages(size_t first = 0) const;
+
+    // Messages followed by the counted events, one per line
+    std::string GetText() const;
+
+    static const size_t kMaxMessages;
+
+private:
+    void _Write(Level level, const std::string &message);
+
+    const MriGeoReaderHost &_host;
+    const char *_name;
+    int _level;
+    ImportLog *_parent;
+    std::vector<std::string> _messages;
+    // Warnings in _messages, read by IsEnabled without taking the lock, and
+    // warnings left out of them
+    std::atomic<size_t> _warningCount;
+    std::atomic<size_t> _droppedWarnings;
+    std::vector<std::string> _traces;
+    std::map<std::pair<std::string, std::string>, size_t> _counts;
+    mutable std::mutex _mutex;
+};
+
+#endif
@@ -0,0 +1,263 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "ImportReport.h"
+
+#include "pxr/base/js/json.h"
+#include "pxr/base/tf/envSetting.h"
+
+#include <sstream>
+#include <time.h>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_ENV_SETTING(MARI_USD_IMPORT_REPORT_DIR, "",
+        "Directory to write a JSON report of every USD import to, along with "
+        "an index of all imports (imports.jsonl). Empty disables it.");
+
+//------------------------------------------------------------------------------
+// ImportReport implementation
+//------------------------------------------------------------------------------
+
+ImportReport::ImportReport(const string &fileName) :
+    _fileName(fileName)
+{
+}
+
+const string&
+ImportReport::GetDirectory()
+{
+    static const string directory = TfGetEnvSetting(MARI_USD_IMPORT_REPORT_DIR);
+    return directory;
+}
+
+void
+ImportReport::SetOption(const string &name, const string &value)
+{
+    _options[name] = value;
+}
+
+void
+ImportReport::SetStats(const map<string, string> &stats)
+{
+    _stats = stats;
+}
+
+void
+ImportReport::SetResult(const string &result)
+{
+    _result = result;
+}
+
+void
+ImportReport::AddModel(const Model &model)
+{
+    _models.push_back(model);
+}
+
+void
+ImportReport::AddMesh(Mesh &&mesh)
+{
+    _meshes.push_back(std::move(mesh));
+}
+
+void
+ImportReport::AddWarning(const string &warning)
+{
+    _warnings.push_back(warning);
+}
+
+void
+ImportReport::SetRemovedMeshes(const vector<string> &paths)
+{
+    _removedMeshes = paths;
+}
+
+static void
+_WriteStringMap(JsWriter &writer, const map<string, string> &values)
+{
+    writer.BeginObject();
+    for (const auto &it : values)
+    {
+        writer.WriteKey(it.first);
+        writer.WriteValue(it.second);
+    }
+    writer.EndObject();
+}
+
+static void
+_WriteStringArray(JsWriter &writer, const vector<string> &values)
+{
+    writer.BeginArray();
+    for (const string &value : values)
+    {
+        writer.WriteValue(value);
+    }
+    writer.EndArray();
+}
+
+void
+ImportReport::Write(FILE *file) const
+{
+    ostringstream oss;
+    JsWriter writer(oss, JsWriter::Style::Pretty);
+
+    writer.BeginObject();
+    writer.WriteKey("file");
+    writer.WriteValue(_fileName);
+    writer.WriteKey("time");
+    writer.WriteValue(int64_t(time(nullptr)));
+    writer.WriteKey("result");
+    writer.WriteValue(_result);
+
+    writer.WriteKey("options");
+    _WriteStringMap(writer, _options);
+    writer.WriteKey("stats");
+    _WriteStringMap(writer, _stats);
+
+    writer.WriteKey("models");
+    writer.BeginArray();
+    for (const Model &model : _models)
+    {
+        writer.BeginObject();
+        writer.WriteKey("name");
+        writer.WriteValue(model.name);
+        writer.WriteKey("path");
+        writer.WriteValue(model.path);
+        writer.WriteKey("gprims");
+        writer.WriteValue(uint64_t(model.gprims));
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.WriteKey("meshes");
+    writer.BeginArray();
+    for (const Mesh &mesh : _meshes)
+    {
+        writer.BeginObject();
+        writer.WriteKey("path");
+        writer.WriteValue(mesh.path);
+        writer.WriteKey("model");
+        writer.WriteValue(mesh.model);
+        writer.WriteKey("imported");
+        writer.WriteValue(mesh.imported);
+        if (!mesh.imported)
+        {
+            writer.WriteKey("rejectReason");
+            writer.WriteValue(mesh.rejectReason);
+        }
+        writer.WriteKey("faces");
+        writer.WriteValue(uint64_t(mesh.faces));
+        writer.WriteKey("points");
+        writer.WriteValue(uint64_t(mesh.points));
+        writer.WriteKey("uvs");
+        writer.WriteValue(mesh.hasUVs);
+        writer.WriteKey("normals");
+        writer.WriteValue(mesh.hasNormals);
+        writer.WriteKey("subdiv");
+        writer.WriteValue(mesh.isSubdiv);
+        if (!mesh.duplicateOf.empty())
+        {
+            writer.WriteKey("duplicateOf");
+            writer.WriteValue(mesh.duplicateOf);
+        }
+        if (!mesh.change.empty())
+        {
+            writer.WriteKey("change");
+            writer.WriteValue(mesh.change);
+        }
+        if (!mesh.topology.empty())
+        {
+            writer.WriteKey("topology");
+            writer.WriteValue(mesh.topology);
+        }
+        if (mesh.removedPoints > 0 || mesh.removedFaces > 0)
+        {
+            writer.WriteKey("removedPoints");
+            writer.WriteValue(uint64_t(mesh.removedPoints));
+            writer.WriteKey("removedFaces");
+            writer.WriteValue(uint64_t(mesh.removedFaces));
+        }
+        if (!mesh.udimTiles.empty())
+        {
+            writer.WriteKey("udimTiles");
+            writer.WriteValue(mesh.udimTiles);
+        }
+        if (mesh.meshObjects > 1)
+        {
+            writer.WriteKey("meshObjects");
+            writer.WriteValue(uint64_t(mesh.meshObjects));
+        }
+        if (!mesh.warnings.empty())
+        {
+            writer.WriteKey("warnings");
+            _WriteStringArray(writer, mesh.warnings);
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    if (!_removedMeshes.empty())
+    {
+        writer.WriteKey("removedMeshes");
+        _WriteStringArray(writer, _removedMeshes);
+    }
+
+    writer.WriteKey("warnings");
+    _WriteStringArray(writer, _warnings);
+    writer.EndObject();
+
+    const string document = oss.str();
+    fwrite(document.data(), 1, document.size(), file);
+    fputc('\n', file);
+}
+
+string
+ImportReport::GetSummary(const string &reportPath) const
+{
+    ostringstream oss;
+    JsWriter writer(oss);
+
+    writer.BeginObject();
+    writer.WriteKey("file");
+    writer.WriteValue(_fileName);
+    writer.WriteKey("time");
+    writer.WriteValue(int64_t(time(nullptr)));
+    writer.WriteKey("result");
+    writer.WriteValue(_result);
+    writer.WriteKey("report");
+    writer.WriteValue(reportPath);
+    writer.WriteKey("stats");
+    _WriteStringMap(writer, _stats);
+    writer.EndObject();
+
+    return oss.str();
+}
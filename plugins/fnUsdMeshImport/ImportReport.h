@@ -0,0 +1,108 @@
+#ifndef IMPORT_REPORT_H
+#define IMPORT_REPORT_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+class ImportReport
+{
+    // Structured report of one import: options, counters, models, meshes and
+    // warnings. Everything is buffered in memory while the import runs and
+    // serialised as a single JSON document once it is done, so that the
+    // per-mesh loops do not have to do any I/O.
+public:
+    struct Model
+    {
+        std::string name;
+        std::string path;
+        size_t gprims = 0;
+    };
+
+    struct Mesh
+    {
+        std::string path;
+        std::string model;
+        bool imported = false;
+        std::string rejectReason;
+        size_t faces = 0;
+        size_t points = 0;
+        bool hasUVs = false;
+        bool hasNormals = false;
+        bool isSubdiv = false;
+        std::string duplicateOf;    // mesh whose channels were reused, if any
+        std::string change;         // re-import: "changed" or "added"
+        std::string topology;       // GeoData topology fingerprint
+        size_t removedPoints = 0;   // by "Clean Up Meshes"
+        size_t removedFaces = 0;
+        size_t meshObjects = 0;     // when split over several
+        std::string udimTiles;      // "1001-1003 1011", with uvs
+        std::vector<std::string> warnings;
+    };
+
+    explicit ImportReport(const std::string &fileName);
+
+    // Directory to write reports to, from MARI_USD_IMPORT_REPORT_DIR.
+    // Reporting is disabled when empty.
+    static const std::string& GetDirectory();
+    static bool IsEnabled() {return !GetDirectory().empty();}
+
+    void SetOption(const std::string &name, const std::string &value);
+    void SetStats(const std::map<std::string, std::string> &stats);
+    void SetResult(const std::string &result);
+    void AddModel(const Model &model);
+    void AddMesh(Mesh &&mesh);
+    void AddWarning(const std::string &warning);
+    // Re-import: meshes of the previous import no longer in the file
+    void SetRemovedMeshes(const std::vector<std::string> &paths);
+
+    // Writes the whole report as a JSON document
+    void Write(FILE *file) const;
+
+    // One line JSON summary, for the import index
+    std::string GetSummary(const std::string &reportPath) const;
+
+private:
+    std::string _fileName;
+    std::string _result;
+    std::map<std::string, std::string> _options;
+    std::map<std::string, std::string> _stats;
+    std::vector<Model> _models;
+    std::vector<Mesh> _meshes;
+    std::vector<std::string> _warnings;
+    std::vector<std::string> _removedMeshes;
+};
+
+#endif
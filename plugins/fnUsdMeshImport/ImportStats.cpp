@@ -0,0 +1,88 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "ImportStats.h"
+#include "pxr/base/tf/stringUtils.h"
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+//------------------------------------------------------------------------------
+// ImportStats implementation
+//------------------------------------------------------------------------------
+
+void
+ImportStats::RejectMesh(const string &reason)
+{
+    ++meshesRejected;
+    ++rejectReasons[reason.empty() ? "unknown" : reason];
+}
+
+map<string, string>
+ImportStats::GetAttributes() const
+{
+    string reasons;
+    for (const auto &it : rejectReasons)
+    {
+        if (!reasons.empty())
+            reasons += "; ";
+        reasons += TfStringPrintf("%s: %zu", it.first.c_str(), it.second);
+    }
+
+    map<string, string> attributes;
+    attributes["UsdImportPrimsVisited"] = TfStringify(primsVisited);
+    attributes["UsdImportPrimsPruned"] = TfStringify(primsPruned);
+    attributes["UsdImportMeshesImported"] = TfStringify(meshesImported);
+    attributes["UsdImportMeshesRejected"] = TfStringify(meshesRejected);
+    attributes["UsdImportMeshObjects"] = TfStringify(meshObjects);
+    attributes["UsdImportUniqueMeshes"] = TfStringify(uniqueMeshes);
+    attributes["UsdImportMeshesDeduplicated"] = TfStringify(meshesDeduplicated);
+    attributes["UsdImportMeshesUnchanged"] = TfStringify(meshesUnchanged);
+    attributes["UsdImportMeshesChanged"] = TfStringify(meshesChanged);
+    attributes["UsdImportMeshesAdded"] = TfStringify(meshesAdded);
+    attributes["UsdImportMeshesRemoved"] = TfStringify(meshesRemoved);
+    attributes["UsdImportDedupRatio"] = TfStringPrintf("%.2f", uniqueMeshes ? double(meshesHashed) / uniqueMeshes : 1.0);
+    attributes["UsdImportRejectReasons"] = reasons;
+    attributes["UsdImportFaces"] = TfStringify(faces);
+    attributes["UsdImportPoints"] = TfStringify(points);
+    attributes["UsdImportFrames"] = TfStringify(frames);
+    attributes["UsdImportBytesCreateGeoData"] = TfStringify(bytesCreateGeoData);
+    attributes["UsdImportBytesSetGeoDataForFrame"] = TfStringify(bytesSetGeoDataForFrame);
+    attributes["UsdImportHostCalls"] = TfStringify(hostCalls);
+    attributes["UsdImportUdimTiles"] = TfStringify(udimTiles.count());
+    attributes["UsdImportFacesOutsideUdims"] = TfStringify(facesOutsideUdims);
+    attributes["UsdImportOpenStageMs"] = TfStringPrintf("%.3f", openStageTimer.GetSeconds() * 1000.0);
+    attributes["UsdImportTraverseMs"] = TfStringPrintf("%.3f", traverseTimer.GetSeconds() * 1000.0);
+    attributes["UsdImportHashMs"] = TfStringPrintf("%.3f", hashTimer.GetSeconds() * 1000.0);
+    attributes["UsdImportExtractMs"] = TfStringPrintf("%.3f", extractTimer.GetSeconds() * 1000.0);
+    attributes["UsdImportUploadMs"] = TfStringPrintf("%.3f", uploadTimer.GetSeconds() * 1000.0);
+    attributes["UsdImportTotalMs"] = TfStringPrintf("%.3f", totalTimer.GetSeconds() * 1000.0);
+    return attributes;
+}
@@ -0,0 +1,84 @@
+#ifndef IMPORT_STATS_H
+#define IMPORT_STATS_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "pxr/base/tf/stopwatch.h"
+
+#include "GeoDataKernels.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+struct ImportStats
+{
+    // Performance counters filled by UsdReader::Load during one import and
+    // saved as attributes on the geo entity, so that pipeline tools can
+    // collect the import cost of each asset.
+public:
+    size_t primsVisited = 0;
+    size_t primsPruned = 0;         // invisible subtrees skipped
+    size_t meshesImported = 0;
+    size_t meshesRejected = 0;
+    size_t meshObjects = 0;         // less than meshesImported when meshes are consolidated
+    size_t meshesHashed = 0;        // topology hashed for deduplication
+    size_t uniqueMeshes = 0;        // distinct MeshHash among the meshes hashed
+    size_t meshesDeduplicated = 0;  // imported sharing the channels of another mesh
+    size_t meshesUnchanged = 0;     // re-import: skipped, same hash as the previous import
+    size_t meshesChanged = 0;
+    size_t meshesAdded = 0;
+    size_t meshesRemoved = 0;
+    std::map<std::string, size_t> rejectReasons;
+    size_t faces = 0;
+    size_t points = 0;
+    size_t frames = 0;
+    size_t bytesCreateGeoData = 0;
+    size_t bytesSetGeoDataForFrame = 0;
+    size_t hostCalls = 0;           // geometry and entity calls, excluding attributes and trace
+    GeoDataKernels::UdimTiles udimTiles;    // occupied by the uvs of the mesh objects
+    size_t facesOutsideUdims = 0;
+
+    // Phase timings
+    PXR_NS::TfStopwatch openStageTimer;
+    PXR_NS::TfStopwatch traverseTimer;
+    PXR_NS::TfStopwatch hashTimer;      // MeshHash of the meshes, for deduplication and re-import (patches extract them to hash them)
+    PXR_NS::TfStopwatch extractTimer;   // GeoData construction
+    PXR_NS::TfStopwatch uploadTimer;    // host calls in _MakeGeoEntity
+    PXR_NS::TfStopwatch totalTimer;
+
+    void RejectMesh(const std::string &reason);
+
+    // Attribute name -> value, as written on the entity
+    std::map<std::string, std::string> GetAttributes() const;
+};
+
+#endif
@@ -0,0 +1,307 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "MeshHash.h"
+#include "GeoData.h"
+#include "GeoDataKernels.h"
+
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/tf/token.h"
+#include "pxr/base/trace/trace.h"
+#include "pxr/base/vt/array.h"
+#include "pxr/usd/usdGeom/mesh.h"
+#include "pxr/usd/usdGeom/primvarsAPI.h"
+
+#include <cstdlib>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace
+{
+    template <typename T>
+    void _HashArray(uint64_t &hash, const VtArray<T> &array)
+    {
+        hash = GeoDataKernels::Hash64(array.cdata(), array.size() * sizeof(T), hash);
+    }
+
+    void _HashToken(uint64_t &hash, const TfToken &token)
+    {
+        hash = GeoDataKernels::Hash64(token.GetText(), token.size(), hash);
+    }
+
+    // Hashes the attribute's value, or an empty array if it has none, so that
+    // every attribute always contributes to the hash in the same order
+    template <typename T>
+    void _HashAttribute(uint64_t &hash, const UsdAttribute &attr)
+    {
+        VtArray<T> array;
+        attr.Get(&array);
+        _HashArray(hash, array);
+    }
+
+    void _HashTokenAttribute(uint64_t &hash, const UsdAttribute &attr, UsdTimeCode time)
+    {
+        TfToken token;
+        attr.Get(&token, time);
+        _HashToken(hash, token);
+    }
+
+    // Everything is read at the same times as GeoData reads it
+    UsdTimeCode _TopologyTime(const UsdGeomMesh &mesh)
+    {
+        const bool isTopologyVarying = mesh.GetFaceVertexIndicesAttr().GetNumTimeSamples() >= 1;
+        return isTopologyVarying ? UsdTimeCode::EarliestTime() : UsdTimeCode::Default();
+    }
+
+    // GeoData's arrays, skipped when empty since their data may not be
+    // addressable
+    template <typename T>
+    void _HashData(uint64_t &hash, const T *data, size_t size)
+    {
+        if (size > 0)
+        {
+            hash = GeoDataKernels::Hash64(data, size * sizeof(T), hash);
+        }
+    }
+}
+
+MeshHash
+MeshHash::ComputeTopology(UsdPrim const &prim)
+{
+    TRACE_FUNCTION();
+
+    UsdGeomMesh mesh(prim);
+    if (!mesh)
+    {
+        return MeshHash();
+    }
+
+    const UsdTimeCode topologyTime = _TopologyTime(mesh);
+
+    uint64_t topology = 0;
+    {
+        VtIntArray faceVertexCounts;
+        VtIntArray faceVertexIndices;
+        if (!mesh.GetFaceVertexCountsAttr().Get(&faceVertexCounts, topologyTime) ||
+            !mesh.GetFaceVertexIndicesAttr().Get(&faceVertexIndices, topologyTime))
+        {
+            return MeshHash();
+        }
+        _HashArray(topology, faceVertexCounts);
+        _HashArray(topology, faceVertexIndices);
+
+        _HashAttribute<int>(topology, mesh.GetCreaseIndicesAttr());
+        _HashAttribute<int>(topology, mesh.GetCreaseLengthsAttr());
+        _HashAttribute<float>(topology, mesh.GetCreaseSharpnessesAttr());
+        _HashAttribute<int>(topology, mesh.GetCornerIndicesAttr());
+        _HashAttribute<float>(topology, mesh.GetCornerSharpnessesAttr());
+        _HashAttribute<int>(topology, mesh.GetHoleIndicesAttr());
+
+        _HashTokenAttribute(topology, mesh.GetSubdivisionSchemeAttr(), UsdTimeCode::Default());
+        _HashTokenAttribute(topology, mesh.GetInterpolateBoundaryAttr(), UsdTimeCode::EarliestTime());
+        _HashTokenAttribute(topology, mesh.GetFaceVaryingLinearInterpolationAttr(), UsdTimeCode::EarliestTime());
+        _HashTokenAttribute(topology, mesh.GetTriangleSubdivisionRuleAttr(), UsdTimeCode::EarliestTime());
+        // Generated normals and the entity's reverse orientation follow it
+        _HashTokenAttribute(topology, mesh.GetOrientationAttr(), UsdTimeCode::Default());
+    }
+
+    MeshHash hash;
+    hash.topology = topology;
+    return hash;
+}
+
+bool
+MeshHash::ComputeContent(UsdPrim const &prim,
+                         const std::string &uvSet,
+                         const std::vector<std::string> &additionalUvSets,
+                         const std::vector<int> &frames)
+{
+    TRACE_FUNCTION();
+
+    UsdGeomMesh mesh(prim);
+    if (!mesh)
+    {
+        *this = MeshHash();
+        return false;
+    }
+
+    const UsdTimeCode topologyTime = _TopologyTime(mesh);
+
+    content = 0;
+    {
+        VtVec3fArray points;
+        for (int frame : frames)
+        {
+            if (!mesh.GetPointsAttr().Get(&points, frame))
+            {
+                *this = MeshHash();
+                return false;
+            }
+            _HashArray(content, points);
+        }
+
+        UsdGeomPrimvarsAPI primvarsApi(mesh);
+
+        auto hashUvSet = [&](const std::string &name)
+        {
+            VtVec2fArray uvs;
+            VtIntArray uvIndices;
+            UsdGeomPrimvar uvPrimvar = name.empty() ? UsdGeomPrimvar() : primvarsApi.GetPrimvar(TfToken(name));
+            if (uvPrimvar)
+            {
+                _HashToken(content, uvPrimvar.GetTypeName().GetAsToken());
+                _HashToken(content, uvPrimvar.GetInterpolation());
+                uvPrimvar.Get(&uvs, UsdTimeCode::EarliestTime());
+                uvPrimvar.GetIndices(&uvIndices, topologyTime);
+            }
+            else if (!name.empty())
+            {
+                // Split u_<name> and v_<name> components, if any
+                for (const char *prefix : {"u_", "v_"})
+                {
+                    VtFloatArray component;
+                    VtIntArray componentIndices;
+                    if (UsdGeomPrimvar componentPrimvar = primvarsApi.GetPrimvar(TfToken(prefix + name)))
+                    {
+                        _HashToken(content, componentPrimvar.GetInterpolation());
+                        componentPrimvar.Get(&component, UsdTimeCode::EarliestTime());
+                        componentPrimvar.GetIndices(&componentIndices, topologyTime);
+                    }
+                    _HashArray(content, component);
+                    _HashArray(content, componentIndices);
+                }
+            }
+            _HashArray(content, uvs);
+            _HashArray(content, uvIndices);
+        };
+        hashUvSet(uvSet);
+        for (const std::string &name : additionalUvSets)
+        {
+            _HashToken(content, TfToken(name));
+            hashUvSet(name);
+        }
+
+        VtVec3fArray normals;
+        VtIntArray normalIndices;
+        TfToken normalsInterpolation;
+        if (UsdGeomPrimvar normalsPrimvar = primvarsApi.GetPrimvar(UsdGeomTokens->normals))
+        {
+            normalsPrimvar.Get(&normals, UsdTimeCode::EarliestTime());
+            normalsPrimvar.GetIndices(&normalIndices, topologyTime);
+            normalsInterpolation = normalsPrimvar.GetInterpolation();
+        }
+        else
+        {
+            mesh.GetNormalsAttr().Get(&normals, topologyTime);
+            normalsInterpolation = mesh.GetNormalsInterpolation();
+        }
+        _HashToken(content, normalsInterpolation);
+        _HashArray(content, normals);
+        _HashArray(content, normalIndices);
+    }
+    return true;
+}
+
+MeshHash
+MeshHash::FromGeoData(GeoData &geom, const std::vector<int> &frames)
+{
+    TRACE_FUNCTION();
+
+    if (!geom)
+    {
+        return MeshHash();
+    }
+
+    // The topology fingerprint covers the face vertex counts, vertex and
+    // uv indices
+    uint64_t topology = geom.GetTopologyFingerprint();
+    _HashData(topology, geom.GetCreaseIndices(), geom.GetNumCreaseIndices());
+    _HashData(topology, geom.GetCreaseLengths(), geom.GetNumCreaseLengths());
+    _HashData(topology, geom.GetCreaseSharpness(), geom.GetNumCreaseSharpness());
+    _HashData(topology, geom.GetCornerIndices(), geom.GetNumCornerIndices());
+    _HashData(topology, geom.GetCornerSharpness(), geom.GetNumCornerSharpness());
+    _HashData(topology, geom.GetHoleIndicess(), geom.GetNumHoleIndices());
+    const std::string subdiv = TfStringPrintf("%d %s %d %d %d %d %d", int(geom.IsSubdivMesh()), geom.SubdivisionScheme().c_str(),
+                                              geom.InterpolateBoundary(), geom.FaceVaryingLinearInterpolation(),
+                                              geom.PropagateCorner(), geom.TriangleSubdivision(), int(geom.IsLeftHanded()));
+    topology = GeoDataKernels::Hash64(subdiv.data(), subdiv.size(), topology);
+
+    // The points are transformed, so a moved mesh hashes differently.
+    // Generated normals follow from the points and the topology.
+    uint64_t content = 0;
+    for (int frame : frames)
+    {
+        _HashData(content, geom.GetVertices(frame), geom.GetNumPoints());
+    }
+    if (geom.HasNormals() && !geom.HasGeneratedNormals())
+    {
+        _HashData(content, geom.GetNormals(frames.empty() ? 0 : frames.front()), geom.GetNumNormals());
+        _HashData(content, geom.GetNormalIndices(), geom.GetNumVertexIndices());
+    }
+    if (geom.HasUVs())
+    {
+        _HashData(content, geom.GetUVs(), geom.GetNumUvs());
+    }
+    const std::vector<GeoData::AdditionalUvSet> &additionalUvSets = geom.GetAdditionalUvSets();
+    for (size_t i = 0; i < additionalUvSets.size(); ++i)
+    {
+        const std::vector<int> &indices = geom.GetAdditionalUvIndices(i);
+        content = GeoDataKernels::Hash64(additionalUvSets[i].name.data(), additionalUvSets[i].name.size(), content);
+        _HashData(content, additionalUvSets[i].uvs.data(), additionalUvSets[i].uvs.size());
+        _HashData(content, indices.data(), indices.size());
+    }
+
+    MeshHash hash;
+    hash.topology = topology;
+    hash.content = content;
+    return hash;
+}
+
+std::string
+MeshHash::ToString() const
+{
+    return TfStringPrintf("%016llx%016llx",
+                          (unsigned long long)topology,
+                          (unsigned long long)content);
+}
+
+MeshHash
+MeshHash::FromString(const std::string &str)
+{
+    MeshHash hash;
+    if (str.size() != 32)
+    {
+        return hash;
+    }
+    hash.topology = strtoull(str.substr(0, 16).c_str(), nullptr, 16);
+    hash.content = strtoull(str.substr(16, 16).c_str(), nullptr, 16);
+    return hash;
+}
@@ -0,0 +1,89 @@
+#ifndef MESH_HASH_H
+#define MESH_HASH_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pxr/usd/usd/prim.h"
+
+class GeoData;
+
+struct MeshHash
+{
+    // Hashes of the data GeoData holds for a mesh. Hashed from the
+    // authored attributes, before the mesh's transform is applied, two
+    // meshes with the same hashes make the same GeoData up to their points,
+    // so the second one can share the channels of the first (see GeoData's
+    // duplicate constructor). Hashed from an extracted GeoData, they tell
+    // whether a re-import would upload the same mesh.
+public:
+    uint64_t topology = 0;      // face vertex counts and indices, subdiv tags, orientation
+    uint64_t content = 0;       // points at each frame, uvs and normals
+
+    // Reads the topology attributes GeoData reads, leaving content at 0.
+    // The hash is not valid if the mesh cannot be read, so that it never
+    // matches another one.
+    static MeshHash ComputeTopology(PXR_NS::UsdPrim const &prim);
+
+    // Reads the points, uvs and normals GeoData reads, which is most of
+    // the cost of hashing a mesh: only worth it for meshes whose topology
+    // matches another's. Invalidates the hash if the mesh cannot be read.
+    bool ComputeContent(PXR_NS::UsdPrim const &prim,
+                        const std::string &uvSet,
+                        const std::vector<std::string> &additionalUvSets,
+                        const std::vector<int> &frames);
+
+    // Hashes what is uploaded to Mari for the mesh, points included, so
+    // that a moved mesh does not match its previous import. Not valid for
+    // a mesh that could not be read.
+    static MeshHash FromGeoData(GeoData &geom, const std::vector<int> &frames);
+
+    // Hex string of the two hashes, and back. FromString returns an
+    // invalid hash if the string is not one.
+    std::string ToString() const;
+    static MeshHash FromString(const std::string &str);
+
+    bool IsValid() const {return topology != 0 || content != 0;}
+
+    bool operator==(const MeshHash &other) const
+    {
+        return topology == other.topology && content == other.content;
+    }
+    bool operator<(const MeshHash &other) const
+    {
+        return topology < other.topology || (topology == other.topology && content < other.content);
+    }
+};
+
+#endif //MESH_HASH_H
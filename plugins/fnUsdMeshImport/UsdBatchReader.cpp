@@ -0,0 +1,245 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "UsdBatchReader.h"
+
+#include "pxr/base/tf/pathUtils.h"
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/trace/trace.h"
+#include "pxr/base/work/loops.h"
+
+#include <fstream>
+#include <time.h>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+UsdBatchReader::UsdBatchReader(const char* pFileName,
+                               MriGeoReaderHost &pHost) :
+    _pluginName("UsdBatchReader"),
+    _fileName(pFileName),
+    _host(pHost),
+    _log(_host, _pluginName)
+{
+}
+
+bool
+UsdBatchReader::IsBatchFile(const std::string &fileName)
+{
+    return TfStringEndsWith(fileName, ".usdlist");
+}
+
+bool
+UsdBatchReader::_ReadFileList()
+{
+    ifstream list(_fileName);
+    if (!list)
+    {
+        MARI_USD_LOG_ERROR(_log, "Cannot read file list %s", _fileName);
+        return false;
+    }
+
+    const string listDirectory = TfGetPathName(TfAbsPath(_fileName));
+    string line;
+    while (getline(list, line))
+    {
+        line = TfStringTrim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        _fileNames.push_back(TfIsRelativePath(line) ? TfStringCatPaths(listDirectory, line) : line);
+    }
+
+    if (_fileNames.empty())
+    {
+        MARI_USD_LOG_ERROR(_log, "File list %s is empty!", _fileName);
+        return false;
+    }
+
+    // _fileNames is not resized from here on, the readers keep pointers to
+    // its strings
+    for (const string &fileName : _fileNames)
+    {
+        _readers.emplace_back(new UsdReader(fileName.c_str(), _host));
+    }
+    _fileLogs.resize(_readers.size());
+
+    MARI_USD_LOG_INFO(_log, "Batch of %zu files from %s", _fileNames.size(), _fileName);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Scan all the files for uv sets, in parallel
+
+MriGeoPluginResult
+UsdBatchReader::GetSettings(MriUserItemHandle SettingsHandle)
+{
+    TRACE_FUNCTION();
+
+    if (!_ReadFileList())
+        return MRI_GPR_FILE_OPEN_FAILED;
+
+    vector<GeoData::UVSet> fileUvs(_readers.size());
+    vector<int> fileSizes(_readers.size(), 0);
+    vector<MriGeoPluginResult> results(_readers.size(), MRI_GPR_FAILED);
+    WorkParallelForN(_readers.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            results[i] = _readers[i]->_CollectUvSets(fileUvs[i], fileSizes[i]);
+        }
+    });
+
+    // A uv set is offered if any of the files has it
+    GeoData::UVSet uvs;
+    int size = 0;
+    bool anySucceeded = false;
+    for (size_t i = 0; i < _readers.size(); ++i)
+    {
+        _readers[i]->_log.FlushTraces();
+        if (results[i] != MRI_GPR_SUCCEEDED)
+        {
+            MARI_USD_LOG_WARNING(_log, "Cannot read settings of %s", _fileNames[i].c_str());
+            continue;
+        }
+        anySucceeded = true;
+        for (const auto &it : fileUvs[i])
+        {
+            uvs[it.first] += it.second;
+        }
+        size += fileSizes[i];
+    }
+
+    _log.FlushTraces();
+    if (!anySucceeded)
+        return MRI_GPR_FAILED;
+
+    _readers.front()->_ParseUVs(SettingsHandle, uvs, size);
+    return MRI_GPR_SUCCEEDED;
+}
+
+//------------------------------------------------------------------------------
+// Read and extract all the files in parallel, then upload them one by one
+
+MriGeoPluginResult
+UsdBatchReader::Load(MriGeoEntityHandle &Entity)
+{
+    TRACE_FUNCTION();
+
+    const clock_t startTime = clock();
+
+    if (!_ReadFileList())
+        return MRI_GPR_FILE_OPEN_FAILED;
+
+    // The options are set on the batch entity, and apply to all the files
+    UsdReader::LoadOptions options;
+    _readers.front()->_GetMariAttributes(Entity, options);
+    // The child entities are made anew by every import, there is nothing to
+    // compare the files with
+    options.changedMeshesOnly = false;
+    options.previousMeshHashes.clear();
+
+    {
+        TRACE_SCOPE("UsdBatchReader: read and extract");
+        // One task per file; each reader extracts its meshes with nested
+        // tasks in the same thread pool
+        WorkParallelForN(_readers.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                _readers[i]->_Read(options, true);
+            }
+        });
+    }
+
+    _host.setEntityType(Entity, MRI_SET_ENTITY);
+
+    TRACE_SCOPE("UsdBatchReader: upload");
+    size_t imported = 0;
+    for (size_t i = 0; i < _readers.size(); ++i)
+    {
+        UsdReader &reader = *_readers[i];
+        const char *fileName = _fileNames[i].c_str();
+
+        if (reader._readResult == MRI_GPR_SUCCEEDED)
+        {
+            MriGeoEntityHandle childEntity;
+            if (_host.createChildGeoEntity(Entity, fileName, &childEntity) == MRI_GPR_SUCCEEDED)
+            {
+                string name = TfStringGetBeforeSuffix(TfGetBaseName(_fileNames[i]));
+                _host.setEntityName(childEntity, name.c_str());
+                if (reader._Upload(childEntity) == MRI_GPR_SUCCEEDED)
+                    ++imported;
+            }
+            else
+            {
+                MARI_USD_LOG_ERROR(_log, "Cannot create an entity for %s", fileName);
+            }
+        }
+        else
+        {
+            reader._log.FlushTraces();
+            MARI_USD_LOG_ERROR(_log, "Skipped %s, it cannot be read", fileName);
+        }
+        _log.FlushTraces();
+
+        // Release the stage and the geometry now that the file is done
+        _fileLogs[i] = reader.GetLog();
+        _readers[i].reset();
+    }
+
+    MARI_USD_LOG_INFO(_log, "Imported %zu of %zu files from %s in %.3f s (cpu)",
+                      imported, _fileNames.size(), _fileName,
+                      double(clock() - startTime) / CLOCKS_PER_SEC);
+    _log.FlushTraces();
+
+    return imported > 0 ? MRI_GPR_SUCCEEDED : MRI_GPR_FAILED;
+}
+
+std::string UsdBatchReader::GetLog()
+{
+    // The batch's own messages, then each file's, prefixed with its name
+    vector<string> lines;
+    string text = _log.GetText();
+    if (!text.empty())
+        lines.push_back(text);
+
+    for (size_t i = 0; i < _fileNames.size(); ++i)
+    {
+        string fileLog = _readers[i] ? _readers[i]->GetLog() : _fileLogs[i];
+        const string prefix = TfGetBaseName(_fileNames[i]) + ": ";
+        for (const string &line : TfStringSplit(fileLog, "\n"))
+        {
+            if (!line.empty())
+                lines.push_back(prefix + line);
+        }
+    }
+    return TfStringJoin(lines, "\n");
+}
@@ -0,0 +1,80 @@
+#ifndef USD_BATCH_READER_H
+#define USD_BATCH_READER_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "MriGeoReaderPlugin.h"
+#include "UsdReader.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Imports the USD files listed in a .usdlist file into one set entity,
+/// one child entity per file. The stages are opened, traversed and their
+/// meshes extracted in parallel; only the upload to the host is serial, so
+/// a batch takes about as long as its slowest file plus the uploads.
+///
+/// A .usdlist file is a text file with one USD file path per line, relative
+/// to the list file or absolute. Blank lines and lines starting with '#' are
+/// ignored. The import options of the batch apply to every file.
+class UsdBatchReader
+{
+    public:
+
+        UsdBatchReader(const char* pFileName, MriGeoReaderHost &pHost);
+
+        static bool IsBatchFile(const std::string &fileName);
+
+        std::string GetLog();
+
+        MriGeoPluginResult Load(MriGeoEntityHandle &pEntity);
+        MriGeoPluginResult GetSettings(MriUserItemHandle SettingsHandle);
+
+    protected:
+        // Reads the list file and makes one reader per listed file
+        bool _ReadFileList();
+
+    protected:
+        const char* _pluginName;
+        const char* _fileName;
+        MriGeoReaderHost _host;
+        ImportLog _log;
+
+        // Absolute paths of the listed files, the readers point into them
+        std::vector<std::string> _fileNames;
+        std::vector<std::unique_ptr<UsdReader> > _readers;
+        // Messages of each reader, kept once it is released
+        std::vector<std::string> _fileLogs;
+};
+
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef USD_IMPORT_API_H
+#define USD_IMPORT_API_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "MriGeoReaderPlugin.h"
+
+#include "MariHostConfig.h"
+
+/// The entry points of the USDImportImpl library, which holds the importer
+/// and everything that links to USD. The USDImport plug-in Mari loads at
+/// startup is only a shim: it loads USDImportImpl the first time a USD file
+/// is imported, and forwards the calls to these functions.
+
+#define USD_IMPORT_IMPL_LIBRARY_NAME "USDImportImpl"
+
+#ifdef _WIN32
+#define USD_IMPORT_IMPL_API extern "C" __declspec(dllexport)
+#else
+#define USD_IMPORT_IMPL_API extern "C" __attribute__((visibility("default")))
+#endif
+
+/// Takes a copy of the host suite. Called once, when the library is loaded,
+/// with warmUp set if it is loaded ahead of the first import (see UsdWarmUp).
+typedef void (*UsdImportSetHostFn)(const MriGeoReaderHost *pHost, bool warmUp);
+/// Same as the load function of the geo reader plug-in suite
+typedef MriGeoPluginResult (*UsdImportLoadFn)(MriGeoEntityHandle Entity,
+        const char *pFileName,
+        const char **ppMessagesOut);
+/// Same as the getSettings function of the geo reader plug-in suite
+typedef MriGeoPluginResult (*UsdImportGetSettingsFn)(MriUserItemHandle SettingsHandle,
+        const char *pFileName);
+/// Called when the plug-in is flushed
+typedef void (*UsdImportFlushFn)();
+
+#define USD_IMPORT_SET_HOST_SYMBOL "usdImportSetHost"
+#define USD_IMPORT_LOAD_SYMBOL "usdImportLoad"
+#define USD_IMPORT_GET_SETTINGS_SYMBOL "usdImportGetSettings"
+#define USD_IMPORT_FLUSH_SYMBOL "usdImportFlush"
+
+#endif
@@ -0,0 +1,222 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "UsdProbe.h"
+
+#include "pxr/base/tf/staticTokens.h"
+#include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/trace/trace.h"
+#include "pxr/usd/sdf/layer.h"
+#include "pxr/usd/sdf/schema.h"
+#include "pxr/usd/sdf/types.h"
+#include "pxr/usd/usdGeom/tokens.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_PRIVATE_TOKENS(
+    _tokens,
+    ((primvarsPrefix, "primvars:"))
+    ((indicesSuffix, ":indices"))
+    ((uPrefix, "u_"))
+    ((vPrefix, "v_"))
+    ((Mesh, "Mesh"))
+);
+
+//------------------------------------------------------------------------------
+// UsdProbe implementation
+//------------------------------------------------------------------------------
+
+bool
+UsdProbe::IsCrateFile(const string &fileName)
+{
+    static const char crateMagic[] = "PXR-USDC";
+
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char header[sizeof(crateMagic) - 1];
+    const bool isCrate = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+                         memcmp(header, crateMagic, sizeof(header)) == 0;
+    fclose(file);
+    return isCrate;
+}
+
+static void
+_ReadLayerMetadata(const SdfLayerRefPtr &layer, UsdProbe::Result &result)
+{
+    result.defaultPrim = layer->GetDefaultPrim().GetString();
+    result.upAxis = layer->GetFieldAs<TfToken>(SdfPath::AbsoluteRootPath(), UsdGeomTokens->upAxis).GetString();
+    if (layer->HasTimeCodesPerSecond())
+        result.timeCodesPerSecond = layer->GetTimeCodesPerSecond();
+    if (layer->HasFramesPerSecond())
+        result.framesPerSecond = layer->GetFramesPerSecond();
+    result.hasTimeRange = layer->HasStartTimeCode() && layer->HasEndTimeCode();
+    if (result.hasTimeRange)
+    {
+        result.startTimeCode = layer->GetStartTimeCode();
+        result.endTimeCode = layer->GetEndTimeCode();
+    }
+    result.subLayers = layer->GetSubLayerPaths();
+}
+
+static void
+_ScanPrimSpec(const SdfLayerRefPtr &layer, const SdfPath &path, UsdProbe::Result &result)
+{
+    if (layer->HasField(path, SdfFieldKeys->References) ||
+        layer->HasField(path, SdfFieldKeys->Payload) ||
+        layer->HasField(path, SdfFieldKeys->InheritPaths) ||
+        layer->HasField(path, SdfFieldKeys->Specializes) ||
+        layer->HasField(path, SdfFieldKeys->VariantSetNames) ||
+        layer->GetFieldAs<SdfSpecifier>(path, SdfFieldKeys->Specifier, SdfSpecifierOver) != SdfSpecifierDef ||
+        !layer->GetFieldAs<bool>(path, SdfFieldKeys->Active, true) ||
+        layer->GetFieldAs<bool>(path, SdfFieldKeys->Instanceable, false))
+    {
+        result.needsComposition = true;
+        return;
+    }
+
+    ++result.primCount;
+    if (layer->GetFieldAs<TfToken>(path, SdfFieldKeys->TypeName) == _tokens->Mesh)
+        ++result.meshCount;
+}
+
+static void
+_ScanAttributeSpec(const SdfLayerRefPtr &layer,
+                   const SdfPath &path,
+                   const UsdProbe::Options &options,
+                   UsdProbe::Result &result)
+{
+    // Same rules as GeoData::GetUvSets
+    const string &name = path.GetName();
+    if (!TfStringStartsWith(name, _tokens->primvarsPrefix) ||
+        TfStringEndsWith(name, _tokens->indicesSuffix))
+        return;
+
+    // Every interpolation GeoData expands uv sets from; primvars without
+    // one are constant
+    const TfToken interpolation = layer->GetFieldAs<TfToken>(path, UsdGeomTokens->interpolation);
+    if (!interpolation.IsEmpty() and
+        interpolation != UsdGeomTokens->constant and
+        interpolation != UsdGeomTokens->uniform and
+        interpolation != UsdGeomTokens->vertex and
+        interpolation != UsdGeomTokens->varying and
+        interpolation != UsdGeomTokens->faceVarying)
+        return;
+
+    const SdfPath primPath = path.GetPrimPath();
+    if (layer->GetFieldAs<TfToken>(primPath, SdfFieldKeys->TypeName) != _tokens->Mesh)
+        return;
+    if (options.meshFilter && !options.meshFilter(primPath.GetString()))
+        return;
+
+    const SdfValueTypeName typeName =
+        SdfSchema::GetInstance().FindType(layer->GetFieldAs<TfToken>(path, SdfFieldKeys->TypeName));
+    const string primvarName = name.substr(_tokens->primvarsPrefix.size());
+
+    if ((TfStringStartsWith(primvarName, _tokens->uPrefix) || TfStringStartsWith(primvarName, _tokens->vPrefix)) and
+        (typeName == SdfValueTypeNames->FloatArray))
+    {
+        ++result.uvSets[primvarName.substr(2)];
+    }
+    else if (typeName == SdfValueTypeNames->TexCoord2fArray ||
+             (options.readFloat2AsUV &&
+              typeName == SdfValueTypeNames->Float2Array))
+    {
+        ++result.uvSets[primvarName];
+    }
+}
+
+UsdProbe::Result
+UsdProbe::Probe(const string &fileName)
+{
+    return Probe(fileName, Options());
+}
+
+UsdProbe::Result
+UsdProbe::Probe(const string &fileName, const Options &options)
+{
+    TRACE_FUNCTION();
+
+    Result result;
+    result.isCrate = IsCrateFile(fileName);
+
+    if (!result.isCrate || !options.scanPrims)
+    {
+        // Only the layer header is parsed
+        SdfLayerRefPtr layer = SdfLayer::OpenAsAnonymous(fileName, /* metadataOnly */ true);
+        if (!layer)
+        {
+            result.error = "Cannot open " + fileName;
+            return result;
+        }
+        _ReadLayerMetadata(layer, result);
+        result.valid = true;
+        return result;
+    }
+
+    // Crate files only read their structure when opened, values are read on
+    // demand. The layer is not composed into a stage.
+    SdfLayerRefPtr layer = SdfLayer::FindOrOpen(fileName);
+    if (!layer)
+    {
+        result.error = "Cannot open " + fileName;
+        return result;
+    }
+    _ReadLayerMetadata(layer, result);
+
+    {
+        TRACE_SCOPE("UsdProbe: scan specs");
+        layer->Traverse(SdfPath::AbsoluteRootPath(), [&](const SdfPath &path)
+        {
+            if (path.ContainsPrimVariantSelection())
+            {
+                result.needsComposition = true;
+            }
+            else if (path.IsPrimPath())
+            {
+                _ScanPrimSpec(layer, path, result);
+            }
+            else if (path.IsPrimPropertyPath() &&
+                     layer->GetSpecType(path) == SdfSpecTypeAttribute)
+            {
+                _ScanAttributeSpec(layer, path, options, result);
+            }
+        });
+    }
+
+    result.primsScanned = true;
+    result.valid = true;
+    return result;
+}
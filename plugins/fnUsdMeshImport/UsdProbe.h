@@ -0,0 +1,100 @@
+#ifndef USD_PROBE_H
+#define USD_PROBE_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+class UsdProbe
+{
+    /*
+    Cheap facts about a USD file, read straight from its root SdfLayer
+    without composing a UsdStage: the layer metadata, and for crate files
+    the prim specs (prim and mesh counts, uv sets). Crate files are memory
+    mapped and their values read on demand, so this stays fast on files of
+    several GB.
+    */
+public:
+    struct Options
+    {
+        // Scan the prim specs of crate files
+        bool scanPrims = true;
+
+        // Same as GeoData::ReadFloat2AsUV()
+        bool readFloat2AsUV = true;
+
+        // Meshes whose path fails this test are left out of the uv sets
+        std::function<bool(const std::string &)> meshFilter;
+    };
+
+    struct Result
+    {
+        bool valid = false;
+        std::string error;
+
+        // Layer metadata
+        bool isCrate = false;
+        std::string defaultPrim;
+        std::string upAxis;                 // empty if not authored
+        double timeCodesPerSecond = 24.0;
+        double framesPerSecond = 24.0;
+        bool hasTimeRange = false;
+        double startTimeCode = 0.0;
+        double endTimeCode = 0.0;
+        std::vector<std::string> subLayers;
+
+        // Prim specs, crate files only
+        bool primsScanned = false;
+        size_t primCount = 0;               // prims UsdStage::Traverse would visit
+        size_t meshCount = 0;
+        std::map<std::string, int> uvSets;  // same counts as GeoData::GetUvSets
+
+        // Set when the composed stage may differ from the specs: sublayers,
+        // composition arcs, variants, over/class specifiers, inactive or
+        // instanceable prims.
+        bool needsComposition = false;
+
+        // True when the prim spec scan describes the stage exactly
+        bool IsSelfContained() const {return primsScanned && !needsComposition && subLayers.empty();}
+    };
+
+    static Result Probe(const std::string &fileName);
+    static Result Probe(const std::string &fileName, const Options &options);
+
+    // True if the file starts with the crate (usdc) magic number
+    static bool IsCrateFile(const std::string &fileName);
+};
+
+#endif
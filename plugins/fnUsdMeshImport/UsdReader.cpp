@@ -31,10 +31,19 @@
 #include "UsdReader.h"
 #include "MriGeoReaderPlugin.h"
 #include "GeoData.h"
+#include "GeoDataKernels.h"
 #include "ModelData.h"
+#include "UsdProbe.h"
 
 #include "pxr/base/arch/systemInfo.h"
+#include "pxr/base/tf/envSetting.h"
+#include "pxr/base/tf/pathUtils.h"
 #include "pxr/base/tf/stringUtils.h"
+#include "pxr/base/trace/collector.h"
+#include "pxr/base/trace/reporter.h"
+#include "pxr/base/trace/trace.h"
+#include "pxr/base/work/loops.h"
+#include "pxr/base/work/threadLimits.h"
 
 #include "pxr/usd/usd/primRange.h"
 #include "pxr/usd/usd/stageCache.h"
@@ -43,6 +52,11 @@
 #include "pxr/usd/usdGeom/metrics.h"
 #include "pxr/usd/usdGeom/primvarsAPI.h"
 
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <time.h>
@@ -50,8 +64,135 @@
 using namespace std;
 PXR_NAMESPACE_USING_DIRECTIVE
 
+TF_DEFINE_ENV_SETTING(MARI_USD_DEDUPLICATE_MESHES, true,
+        "Set to false to read every mesh, instead of reading the channels of "
+        "identical meshes once and sharing them.");
+
+TF_DEFINE_ENV_SETTING(MARI_USD_CHROME_TRACE_DIR, "",
+        "Directory to write a Chrome trace (JSON) of every USD import to. "
+        "Open the files in Perfetto or chrome://tracing. Empty disables it.");
+
+namespace
+{
+    // Collects USD trace events for its lifetime and writes them out as a
+    // Chrome trace when MARI_USD_CHROME_TRACE_DIR is set. USD's own scopes
+    // (composition, crate reads...) are recorded alongside ours.
+    // The collector is global: recorders of concurrent imports share it, it
+    // stays enabled until the last one is done, and their traces overlap.
+    class ChromeTraceRecorder
+    {
+    public:
+        ChromeTraceRecorder(const char* fileName, const MriGeoReaderHost& host)
+            : _host(host)
+        {
+            const std::string traceDir = TfGetEnvSetting(MARI_USD_CHROME_TRACE_DIR);
+            if (traceDir.empty())
+                return;
+
+            static std::atomic<int> traceCount(0);
+            _tracePath = TfStringPrintf("%s/%s.%d.%d.trace.json",
+                                        traceDir.c_str(),
+                                        TfGetBaseName(fileName).c_str(),
+                                        ArchGetProcessId(),
+                                        traceCount++);
+
+            std::lock_guard<std::mutex> lock(_GetMutex());
+            if (_GetActiveCount()++ == 0)
+            {
+                TraceReporter::GetGlobalReporter()->ClearTree();
+                TraceCollector::GetInstance().Clear();
+                TraceCollector::GetInstance().SetEnabled(true);
+            }
+        }
+
+        ~ChromeTraceRecorder()
+        {
+            if (_tracePath.empty())
+                return;
+
+            std::lock_guard<std::mutex> lock(_GetMutex());
+            const bool last = --_GetActiveCount() == 0;
+            if (last)
+            {
+                TraceCollector::GetInstance().SetEnabled(false);
+            }
+
+            std::ofstream out(_tracePath);
+            if (out)
+            {
+                TraceReporter::GetGlobalReporter()->ReportChromeTracing(out);
+                _host.trace("[UsdReader] Wrote import trace to %s", _tracePath.c_str());
+            }
+            else
+            {
+                _host.trace("[UsdReader] Cannot write import trace to %s", _tracePath.c_str());
+            }
+            if (last)
+            {
+                TraceReporter::GetGlobalReporter()->ClearTree();
+            }
+        }
+
+    private:
+        static std::mutex& _GetMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        static int& _GetActiveCount()
+        {
+            static int activeCount = 0;
+            return activeCount;
+        }
+
+        const MriGeoReaderHost& _host;
+        std::string _tracePath;
+    };
+
+    // "0-3 7 9-12": the indices, runs of consecutive ones as ranges
+    std::string _FormatIndexRuns(const int *indices, size_t count)
+    {
+        std::string runs;
+        for (size_t i = 0; i < count;)
+        {
+            size_t last = i;
+            while (last + 1 < count && indices[last + 1] == indices[last] + 1)
+                ++last;
+            if (!runs.empty())
+                runs += ' ';
+            runs += last > i ? TfStringPrintf("%d-%d", indices[i], indices[last]) : TfStringPrintf("%d", indices[i]);
+            i = last + 1;
+        }
+        return runs;
+    }
+
+    // "1001-1003 1011"
+    std::string _FormatUdimTiles(const GeoDataKernels::UdimTiles &tiles)
+    {
+        std::vector<int> udims;
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            if (tiles.test(i))
+                udims.push_back(1001 + int(i));
+        }
+        return _FormatIndexRuns(udims.data(), udims.size());
+    }
+}
+
 std::string UsdReader::kNoUvSetFoundStr = "* no uv set found *";
 
+const std::string UsdReader::kMergeOptions = "Merge Models\nKeep Models Separate\nConsolidate Meshes";
+
+const std::string UsdReader::kConsolidateMeshes = "Consolidate Meshes";
+
+// Face count a consolidated mesh object is closed at
+const size_t UsdReader::kMaxConsolidatedFaces = 1 << 20;
+
+// Face vertex count a mesh object is split at: the host takes int buffer
+// sizes, and the face varying normals are the largest buffer per face vertex
+const size_t UsdReader::kMaxFaceVerticesPerObject = INT_MAX / (3 * sizeof(float));
+
 const std::string UsdReader::kMappingSchemeOptions = "UV if available, Ptex otherwise\nForce Ptex\nUV if available, empty otherwise\nForce empty";
 
 UsdReader::UsdReader(const char* pFileName, 
@@ -59,33 +200,76 @@ UsdReader::UsdReader(const char* pFileName,
     _pluginName("UsdReader"),
     _fileName(pFileName),
     _host(pHost),
+    _log(_host, _pluginName),
+    _report(pFileName),
+    _logFile(nullptr),
+    // Evaluate and store the path substring lists at initialization time so
+    // we don't look at environment variables more than once.
+    _pathFilter(GeoData::PathFilter::FromEnvironment()),
+    _readResult(MRI_GPR_FAILED),
     _startTime(clock())
 {
-    // Evaluate and store PathSubstringLists at initialization time so we don't
-    // look at environment variables more than once.
-    GeoData::InitializePathSubstringLists();
+}
+
+UsdReader::~UsdReader()
+{
+    // clean up
+    for(ModelData* modelData: _modelDataList)
+    {
+        delete modelData;
+    }
 }
 UsdStageRefPtr
-UsdReader::_OpenUsdStage()
+UsdReader::_OpenUsdStage(bool editable, bool reload)
 {
-    _host.trace("[%s:%d] Opening: %s", _pluginName, __LINE__, _fileName);
+    TRACE_FUNCTION();
+
+    MARI_USD_LOG_INFO(_log, "Opening: %s", _fileName);
     
     SdfLayerRefPtr rootLayer = SdfLayer::FindOrOpen(_fileName);
 
-    static UsdStageCache stageCache;
-    UsdStageCacheContext ctx(stageCache);
-    UsdStageRefPtr stage = UsdStage::Open(rootLayer);
+    UsdStageRefPtr stage;
+    if (editable)
+    {
+        // The root layer is shared with every other stage that has the file
+        // open, possibly from other threads: author into a session layer of
+        // our own instead, and keep the stage out of the shared cache.
+        SdfLayerRefPtr sessionLayer = SdfLayer::CreateAnonymous("UsdReader-session.usda");
+        stage = UsdStage::Open(rootLayer, sessionLayer);
+        if (stage)
+        {
+            stage->SetEditTarget(stage->GetSessionLayer());
+        }
+    }
+    else
+    {
+        // UsdStageCache is thread safe, concurrent imports of the same file
+        // share the stage
+        static UsdStageCache stageCache;
+        UsdStageCacheContext ctx(stageCache);
+        stage = UsdStage::Open(rootLayer);
+    }
 
     if (!stage)
     {
-        _host.trace("%s:%d] Cannot load usd file from %s", _pluginName, __LINE__, _fileName);
-        _log.push_back("Cannot load usd file from " + std::string(_fileName) + ".");
+        MARI_USD_LOG_ERROR(_log, "Cannot load usd file from %s.", _fileName);
         return NULL;
     }
 
+    if (reload)
+    {
+        // The layers stay open for the whole session, held by the stage
+        // cache: a file written over since it was last imported would be
+        // read as it was then. Only the layers changed on disk are read
+        // again. Not done by batches, which open their files on several
+        // threads (see the note on Reload below).
+        const SdfLayerHandleVector usedLayers = stage->GetUsedLayers();
+        SdfLayer::ReloadLayers(std::set<SdfLayerHandle>(usedLayers.begin(), usedLayers.end()));
+    }
+
     TfToken upAxis = UsdGeomGetStageUpAxis(stage);
     m_upAxisIsY = upAxis.data() == UsdGeomTokens->y;
-    _host.trace("[%s:%d] Stage up axis is : %s", _pluginName, __LINE__, m_upAxisIsY ? "y" : "z");
+    MARI_USD_LOG_INFO(_log, "Stage up axis is : %s", m_upAxisIsY ? "y" : "z");
 
     // NOTES FROM RAJIV:
     // The following crashes on windows only. The USD documentation warns against using Reload in the face of threading.
@@ -103,8 +287,41 @@ UsdReader::_OpenUsdStage()
 MriGeoPluginResult 
 UsdReader::GetSettings(MriUserItemHandle SettingsHandle)
 {
+    ChromeTraceRecorder traceRecorder(_fileName, _host);
+    TRACE_FUNCTION();
+
     GeoData::UVSet uvs;
-    UsdStageRefPtr stage = _OpenUsdStage();
+    int size = 0;
+    MriGeoPluginResult result = _CollectUvSets(uvs, size);
+    _log.FlushTraces();
+    if (result == MRI_GPR_SUCCEEDED)
+    {
+        _ParseUVs(SettingsHandle, uvs, size);
+    }
+    return result;
+}
+
+MriGeoPluginResult
+UsdReader::_CollectUvSets(GeoData::UVSet &uvs, int &size)
+{
+    TRACE_FUNCTION();
+
+    // Fast path: a crate file with no composition is fully described by its
+    // prim specs, so there is no need to compose a stage to list its uv sets
+    UsdProbe::Options probeOptions;
+    probeOptions.readFloat2AsUV = GeoData::ReadFloat2AsUV();
+    probeOptions.meshFilter = [this](const std::string &path) { return _pathFilter.Test(path); };
+    UsdProbe::Result probe = UsdProbe::Probe(_fileName, probeOptions);
+    if (probe.IsSelfContained() && probe.primCount > 0)
+    {
+        MARI_USD_LOG_INFO(_log, "Read settings of %s from its prim specs (%zu prims, %zu meshes)",
+                          _fileName, probe.primCount, probe.meshCount);
+        uvs = probe.uvSets;
+        size = int(probe.primCount);
+        return MRI_GPR_SUCCEEDED;
+    }
+
+    UsdStageRefPtr stage = _OpenUsdStage(false, false);
 
     if (!stage)
         return MRI_GPR_FAILED;
@@ -113,24 +330,69 @@ UsdReader::GetSettings(MriUserItemHandle SettingsHandle)
 
     if (range.empty())
     {
-        _host.trace("%s:%d] File %s is empty!", _pluginName, __LINE__, _fileName);
-        _log.push_back("File "+ std::string(_fileName) + " is empty!");
+        MARI_USD_LOG_ERROR(_log, "File %s is empty!", _fileName);
 
         return MRI_GPR_FAILED;
     }
 
-    int size = 0;
-    for (UsdPrim prim: range)
+    TRACE_SCOPE("UsdReader: scan uv sets");
+
+    // Split the stage in subtrees, scanning the prims above them on the way,
+    // until there are enough subtrees to keep all the threads busy.
+    const size_t targetSubtrees = WorkGetConcurrencyLimit() * 4;
+    const int maxSplitDepth = 4;
+
+    size = 0;
+    vector<UsdPrim> subtrees;
+    for (const UsdPrim &child : stage->GetPseudoRoot().GetChildren())
     {
-        if (GeoData::IsValidNode(prim))
+        subtrees.push_back(child);
+    }
+    for (int depth = 0; depth < maxSplitDepth && !subtrees.empty() && subtrees.size() < targetSubtrees; ++depth)
+    {
+        vector<UsdPrim> children;
+        for (const UsdPrim &prim : subtrees)
         {
-            GeoData::GetUvSets(prim, uvs);
+            if (GeoData::IsValidNode(prim, _pathFilter))
+            {
+                GeoData::GetUvSets(prim, uvs);
+            }
+            size++;
 
+            for (const UsdPrim &child : prim.GetChildren())
+            {
+                children.push_back(child);
+            }
         }
-        size++;
+        subtrees.swap(children);
     }
 
-    _ParseUVs(SettingsHandle, uvs, size);
+    // Scan the subtrees in parallel, each into its own map
+    vector<GeoData::UVSet> subtreeUvs(subtrees.size());
+    vector<int> subtreeSizes(subtrees.size(), 0);
+    WorkParallelForN(subtrees.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (const UsdPrim &prim : UsdPrimRange(subtrees[i]))
+            {
+                if (GeoData::IsValidNode(prim, _pathFilter))
+                {
+                    GeoData::GetUvSets(prim, subtreeUvs[i]);
+                }
+                subtreeSizes[i]++;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+        for (const auto &it : subtreeUvs[i])
+        {
+            uvs[it.first] += it.second;
+        }
+        size += subtreeSizes[i];
+    }
 
     return MRI_GPR_SUCCEEDED;
 }
@@ -138,206 +400,669 @@ UsdReader::GetSettings(MriUserItemHandle SettingsHandle)
 MriGeoPluginResult
 UsdReader::Load(MriGeoEntityHandle &Entity)
 {
-    vector<int> frames;
-    std::string loadOption, mergeOption, frameString, UVSet = "", mappingScheme;
-    vector<std::string> requestedModelNames,requestedGprimNames;
-    vector<SdfPath> variantSelections;
-    bool conformToMariY = true;
-    bool keepCentered = false;
-    bool includeInvisible = false;
-    bool createFaceSelectionGroups = false;
+    ChromeTraceRecorder traceRecorder(_fileName, _host);
+    TRACE_FUNCTION();
 
     /////// GET PARAMETERS ////////
-    _GetMariAttributes(Entity,
-                       loadOption, mergeOption, mappingScheme,
-                       frames, frameString, requestedModelNames,
-                       requestedGprimNames, UVSet, variantSelections,
-                       conformToMariY, keepCentered, includeInvisible, createFaceSelectionGroups);
+    LoadOptions options;
+    _GetMariAttributes(Entity, options);
+
+    // Meshes are extracted while uploading, one at a time, so that only one
+    // of them is held in memory. Consolidated meshes are all held until
+    // their model is done, so they may as well be extracted in parallel.
+    _Read(options, options.mergeOption == kConsolidateMeshes);
+    return _Upload(Entity);
+}
 
-    bool loadFirstOnly = loadOption=="First Found";
-    bool loadAll = loadOption=="All Models";
-    bool keepSeparate = mergeOption=="Keep Models Separate";
+MriGeoPluginResult
+UsdReader::_Read(const LoadOptions &options, bool extract)
+{
+    TRACE_FUNCTION();
 
-    /////// READ FILE /////////
-    UsdStageRefPtr stage = _OpenUsdStage();
+    _stats = ImportStats();
+    _stats.totalTimer.Start();
 
-    if (!stage)
-        return MRI_GPR_FILE_OPEN_FAILED;
+    _options = options;
+    _readResult = MRI_GPR_FAILED;
+
+    const bool reporting = ImportReport::IsEnabled();
+    if (reporting)
+    {
+        _report.SetOption("Load", _options.loadOption);
+        _report.SetOption("Merge Type", _options.mergeOption);
+        _report.SetOption("Mapping Scheme", _options.mappingScheme);
+        _report.SetOption("Frame Numbers", _options.frameString);
+        _report.SetOption("Model Names", TfStringJoin(_options.requestedModelNames, ","));
+        _report.SetOption("Gprim Names", TfStringJoin(_options.requestedGprimNames, ","));
+        _report.SetOption("UV Set", _options.UVSet);
+        _report.SetOption("Additional UV Sets", TfStringJoin(_options.additionalUvSets, ","));
+        vector<string> variantStrings;
+        for (const SdfPath &variant : _options.variantSelections)
+            variantStrings.push_back(variant.GetString());
+        _report.SetOption("Variants", TfStringJoin(variantStrings, " "));
+        _report.SetOption("Conform to Mari Y as up", TfStringify(_options.conformToMariY));
+        _report.SetOption("Keep Centered", TfStringify(_options.keepCentered));
+        _report.SetOption("Include Invisible", TfStringify(_options.includeInvisible));
+        _report.SetOption("Create Face Selection Group per mesh", TfStringify(_options.createFaceSelectionGroups));
+        _report.SetOption("Generate Missing Normals", TfStringify(_options.generateNormals));
+        _report.SetOption("Clean Up Meshes", TfStringify(_options.cleanUp));
+        _report.SetOption("Optimise for Painting", TfStringify(_options.reorderForPainting));
+        _report.SetOption("Max Faces per Mesh Object", TfStringify(_options.maxFacesPerObject));
+        _report.SetOption("Patch With Changed Meshes Only", TfStringify(_options.changedMeshesOnly));
+    }
+
+    bool loadFirstOnly = _options.loadOption=="First Found";
+    bool loadAll = _options.loadOption=="All Models";
+
+    /////// READ FILE /////////
+    _stats.openStageTimer.Start();
+    // Variant selections are the only edits made to the stage. A patch is
+    // compared with the previous import of the file as it is now on disk.
+    _stage = _OpenUsdStage(!_options.variantSelections.empty(), _options.changedMeshesOnly);
+    _stats.openStageTimer.Stop();
+
+    if (!_stage)
+        return _readResult = MRI_GPR_FILE_OPEN_FAILED;
     
     /////// LOOP THROUGH ALL PATHS ////////
-    UsdPrimRange range = stage->Traverse();
+    UsdPrimRange range = _stage->Traverse();
 
     if (range.empty())
     {
-        _host.trace("%s:%d] File %s is empty!", _pluginName, __LINE__, _fileName);
-        _log.push_back("File "+ std::string(_fileName) + " is empty!");
-        return MRI_GPR_FAILED;
+        MARI_USD_LOG_ERROR(_log, "File %s is empty!", _fileName);
+        return _readResult = MRI_GPR_FAILED;
     }
 
     // Get the stage prim path to set the root name for USD export
-    UsdPrim stagePrim = stage->GetDefaultPrim();
+    UsdPrim stagePrim = _stage->GetDefaultPrim();
     SdfPath stagePrimPath = stagePrim.GetPath();
-    std::string stagePrimPathString = stagePrimPath.GetString();
-
-    MriAttributeValue stagePrimValue;
-    stagePrimValue.m_Type = MRI_ATTR_STRING;
-    stagePrimValue.m_pString = stagePrimPathString.c_str();
-    _host.setAttribute(Entity, "StagePrimPath", &stagePrimValue);
-
-    MriAttributeValue uvSetValue;
-    uvSetValue.m_Type = MRI_ATTR_STRING;
-    uvSetValue.m_pString = UVSet.c_str();
-    _host.setAttribute(Entity, "UvSetName", &uvSetValue);
+    _stagePrimPath = stagePrimPath.GetString();
     
     // variables used to coordinate which model should be loaded
     bool loadThisModel = false;
     bool oneModelLoaded = false;
     ModelData* currentModelData = nullptr;
-    std::vector<ModelData*> modelDataList;
     
-    for (auto primIt = range.begin(); primIt != range.end(); ++primIt)
-    {
-        // Check to see if this path matches a variant
-        SdfPath path = primIt->GetPath();
-        for(vector<SdfPath>::iterator it = variantSelections.begin();
-            it != variantSelections.end();
-            ++it) 
-        {
-            // The user has requested a variant selection for this prim through the variants parameter.
-            // If it exists, let's set it.
-            if (it->GetAbsoluteRootOrPrimPath() == path) {
-                pair<string,string> variantSelection = it->GetVariantSelection();
-                UsdVariantSet  vs = primIt->GetVariantSet(variantSelection.first);
-                if (vs && vs.IsValid() && vs.HasAuthoredVariant(variantSelection.second)) 
-                {
-                    vs.SetVariantSelection(variantSelection.second);
-                    _host.trace("set variant set %s  =  %s on prim %s", 
-                                variantSelection.first.c_str(),
-                                variantSelection.second.c_str(),
-                                path.GetString().c_str());
+    _stats.traverseTimer.Start();
+    {
+        TRACE_SCOPE("UsdReader: traverse");
+        for (auto primIt = range.begin(); primIt != range.end(); ++primIt)
+        {
+            ++_stats.primsVisited;
+
+            // Check to see if this path matches a variant
+            SdfPath path = primIt->GetPath();
+            for(vector<SdfPath>::const_iterator it = _options.variantSelections.begin();
+                it != _options.variantSelections.end();
+                ++it) 
+            {
+                // The user has requested a variant selection for this prim through the variants parameter.
+                // If it exists, let's set it.
+                if (it->GetAbsoluteRootOrPrimPath() == path) {
+                    pair<string,string> variantSelection = it->GetVariantSelection();
+                    UsdVariantSet  vs = primIt->GetVariantSet(variantSelection.first);
+                    if (vs && vs.IsValid() && vs.HasAuthoredVariant(variantSelection.second)) 
+                    {
+                        vs.SetVariantSelection(variantSelection.second);
+                        MARI_USD_LOG_INFO(_log, "set variant set %s  =  %s on prim %s",
+                                          variantSelection.first.c_str(),
+                                          variantSelection.second.c_str(),
+                                          path.GetText());
+                    }
                 }
             }
-        }
 
-        // get this model Data
-        ModelData thisModelData (*primIt, UVSet);
-        if (thisModelData)
-        {
-            if(oneModelLoaded && loadFirstOnly)
+            // get this model Data
+            ModelData thisModelData (*primIt, _options.UVSet);
+            if (thisModelData)
             {
-                // loaded one model already, so this is the second model. break now
-                break;
+                if(oneModelLoaded && loadFirstOnly)
+                {
+                    // loaded one model already, so this is the second model. break now
+                    break;
+                }
+
+                if(loadAll || loadFirstOnly)
+                {
+                    // load this model because "All" or "First Found" is requested
+                    loadThisModel = true;
+                }
+                else
+                {
+                    // otherwise, load this model only if it's specified in "Model Names"
+                    std::vector<std::string>::const_iterator it = std::find(_options.requestedModelNames.begin(), _options.requestedModelNames.end(), primIt->GetPath().GetText());
+                    loadThisModel = it!=_options.requestedModelNames.end();
+                }
+
+                // Keep metadata for this model
+                if (loadThisModel) 
+                {
+                    currentModelData = new ModelData(thisModelData);
+                    _modelDataList.push_back(currentModelData);
+                }
+                else
+                {
+                    // Reset currentModelData to null so that the gprims belonging to this model will not get loaded
+                    currentModelData = nullptr;
+                }
             }
 
-            if(loadAll || loadFirstOnly)
+            if (not loadThisModel) 
             {
-                // load this model because "All" or "First Found" is requested
-                loadThisModel = true;
+                // this is not a model the user opted in.
+                continue;
             }
-            else
+            UsdGeomImageable imageable = UsdGeomImageable(*primIt);
+            if (!_options.includeInvisible && imageable)
             {
-                // otherwise, load this model only if it's specified in "Model Names"
-                std::vector<std::string>::iterator it = std::find(requestedModelNames.begin(), requestedModelNames.end(), primIt->GetPath().GetText());
-                loadThisModel = it!=requestedModelNames.end();
+                TRACE_SCOPE("UsdReader: compute visibility");
+                TfToken visibility = imageable.ComputeVisibility();
+                if(visibility == UsdGeomTokens->invisible) 
+                {
+                    /*_host.trace("%s:%d] %s Is invisible",
+                        _pluginName, __LINE__, primIt->GetPath().GetText());*/
+                    primIt.PruneChildren();
+                    ++_stats.primsPruned;
+                    continue;
+                } else {
+                    /*_host.trace("%s:%d] %s Is visible",
+                        _pluginName, __LINE__, primIt->GetPath().GetText());*/
+                }
             }
 
-            // Keep metadata for this model
-            if (loadThisModel) 
+            if (not GeoData::IsValidNode(*primIt, _pathFilter)) 
             {
-                currentModelData = new ModelData(thisModelData);
-                modelDataList.push_back(currentModelData);
+                /*_host.trace("[%s:%d] %s Not a valid node", _pluginName, __LINE__, primIt->GetPath().GetText());*/
+                // not even a gprim.
+                continue;
             }
-            else
+
+            // If we've requested specific gprims and 
+            // this gprim isnt' in that list, continue.
+            // We need to search using the full path of the current
+            // gprim as well as the simple name, since either one
+            // may have been passed in.
+            // XXX This might start to get costly with very large lists of
+            // gprims. 2(O^2). 
+
+
+            //_host.trace("%s:%d] looking for %s and %s in requested names %d.", 
+            //            _pluginName, __LINE__, path.GetName().c_str(), path.GetText(), requestedGprimNames.size());
+            if (
+                _options.requestedGprimNames.size() > 0 &&
+                (std::find(_options.requestedGprimNames.begin(),
+                           _options.requestedGprimNames.end(),
+                           path.GetName()) == _options.requestedGprimNames.end()) &&
+                (std::find(_options.requestedGprimNames.begin(),
+                           _options.requestedGprimNames.end(),
+                           path.GetText()) == _options.requestedGprimNames.end()) 
+                ) 
+            {
+                continue;
+            }
+
+            if (currentModelData)
             {
-                // Reset currentModelData to null so that the gprims belonging to this model will not get loaded
-                currentModelData = nullptr;
+                currentModelData->gprims.push_back(*primIt);
+                oneModelLoaded = true;
+            }
+
+            else {
+                MARI_USD_LOG_WARNING(_log, "Could not make mari geo entity with uv set %s for prim %s.",
+                                     _options.UVSet.c_str(), path.GetText());
+                if (reporting)
+                    _report.AddWarning(TfStringPrintf("Could not make mari geo entity with uv set %s for prim %s.",
+                                                      _options.UVSet.c_str(), path.GetText()));
             }
         }
+    }
+    _stats.traverseTimer.Stop();
 
-        if (not loadThisModel) 
+    int modelCount = 0;
+    for (ModelData* modelData: _modelDataList)
+    {
+        if (modelData->gprims.size()>0)
         {
-            // this is not a model the user opted in.
-            continue;
+            ++modelCount;
         }
-        UsdGeomImageable imageable = UsdGeomImageable(*primIt);
-        if (!includeInvisible && imageable)
+    }
+
+    if (modelCount == 0)
+    {
+        // No UsdGeomMesh found to load -> error out now!
+
+        MARI_USD_LOG_ERROR(_log, "> No model of type UsdGeomMesh found to load in %s", _fileName);
+        return _readResult = MRI_GPR_FAILED;
+    }
+
+    // Flatten the gprims of all the models, in the order _Upload visits them
+    _gprims.clear();
+    for (const ModelData* modelData: _modelDataList)
+    {
+        for (const UsdPrim &prim: modelData->gprims)
+        {
+            _gprims.emplace_back(modelData, prim);
+        }
+    }
+
+    _HashMeshes();
+
+    _meshHashes.assign(_gprims.size(), MeshHash());
+    _meshChanges.assign(_gprims.size(), MeshChange::NotCompared);
+    if (_options.changedMeshesOnly)
+    {
+        _HashForPatch();
+        _DiffAgainstPreviousImport();
+    }
+
+    if (extract)
+    {
+        _Extract();
+    }
+
+    return _readResult = MRI_GPR_SUCCEEDED;
+}
+
+void
+UsdReader::_Extract()
+{
+    TRACE_FUNCTION();
+
+    _extracted.clear();
+    _extracted.resize(_gprims.size());
+
+    // Each mesh logs to a log of its own, so that the report can tell
+    // their warnings apart
+    const bool reporting = ImportReport::IsEnabled();
+    _extractedWarnings.clear();
+    _extractedWarnings.resize(reporting ? _gprims.size() : 0);
+
+    // The originals first, then the duplicates sharing their channels
+    _stats.extractTimer.Start();
+    WorkParallelForN(_gprims.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
         {
-            TfToken visibility = imageable.ComputeVisibility();
-            if(visibility == UsdGeomTokens->invisible) 
+            if (_meshOriginals[i] == i && _meshChanges[i] != MeshChange::Unchanged)
             {
-                /*_host.trace("%s:%d] %s Is invisible",
-                    _pluginName, __LINE__, primIt->GetPath().GetText());*/
-                primIt.PruneChildren();
-                continue;
-            } else {
-                /*_host.trace("%s:%d] %s Is visible",
-                    _pluginName, __LINE__, primIt->GetPath().GetText());*/
+                ImportLog meshLog(_log);
+                _extracted[i] = std::make_shared<GeoData>(_gprims[i].second, _options.UVSet, _GetAdditionalUvSets(_gprims[i].second),
+                                                          _options.mappingScheme, _options.generateNormals, _options.cleanUp, _options.reorderForPainting, _options.frames,
+                                                          _options.conformToMariY, m_upAxisIsY, _options.keepCentered,
+                                                          _gprims[i].first->mprim, _host, reporting ? meshLog : _log);
+                if (reporting)
+                    _extractedWarnings[i] = meshLog.GetMessages();
+            }
+        }
+    });
+    WorkParallelForN(_gprims.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (_meshOriginals[i] != i && _meshChanges[i] != MeshChange::Unchanged)
+            {
+                ImportLog meshLog(_log);
+                _extracted[i] = std::make_shared<GeoData>(_extracted[_meshOriginals[i]], _gprims[i].second, _options.frames,
+                                                          _options.conformToMariY, m_upAxisIsY, _options.keepCentered,
+                                                          _gprims[i].first->mprim, reporting ? meshLog : _log);
+                if (reporting)
+                    _extractedWarnings[i] = meshLog.GetMessages();
             }
         }
+    });
+    _stats.extractTimer.Stop();
 
-        if (not GeoData::IsValidNode(*primIt)) 
+    // A patch hashed every mesh already
+    if (_options.changedMeshesOnly)
+        return;
+
+    _stats.hashTimer.Start();
+    WorkParallelForN(_gprims.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
         {
-            /*_host.trace("[%s:%d] %s Not a valid node", _pluginName, __LINE__, primIt->GetPath().GetText());*/
-            // not even a gprim.
+            _meshHashes[i] = MeshHash::FromGeoData(*_extracted[i], _options.frames);
+        }
+    });
+    _stats.hashTimer.Stop();
+}
+
+void
+UsdReader::_HashForPatch()
+{
+    TRACE_FUNCTION();
+
+    // The changed meshes are extracted again to be uploaded, which logs
+    // their messages: none are logged here
+    ImportLog quietLog(_host, _pluginName, true);
+
+    // The originals first, held only until their duplicates are hashed
+    _stats.hashTimer.Start();
+    vector<std::shared_ptr<GeoData> > originals(_gprims.size());
+    WorkParallelForN(_gprims.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (_meshOriginals[i] != i)
+                continue;
+            std::shared_ptr<GeoData> geom = std::make_shared<GeoData>(_gprims[i].second, _options.UVSet, _GetAdditionalUvSets(_gprims[i].second),
+                                                                      _options.mappingScheme, _options.generateNormals, _options.cleanUp, _options.reorderForPainting, _options.frames,
+                                                                      _options.conformToMariY, m_upAxisIsY, _options.keepCentered,
+                                                                      _gprims[i].first->mprim, _host, quietLog);
+            _meshHashes[i] = MeshHash::FromGeoData(*geom, _options.frames);
+            if (_duplicatesLeft[i] > 0)
+                originals[i] = std::move(geom);
+        }
+    });
+    WorkParallelForN(_gprims.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (_meshOriginals[i] == i)
+                continue;
+            GeoData geom(originals[_meshOriginals[i]], _gprims[i].second, _options.frames,
+                         _options.conformToMariY, m_upAxisIsY, _options.keepCentered,
+                         _gprims[i].first->mprim, quietLog);
+            _meshHashes[i] = MeshHash::FromGeoData(geom, _options.frames);
+        }
+    });
+    _stats.hashTimer.Stop();
+}
+
+void
+UsdReader::_HashMeshes()
+{
+    TRACE_FUNCTION();
+
+    _meshOriginals.resize(_gprims.size());
+    _duplicatesLeft.assign(_gprims.size(), 0);
+    _originals.clear();
+    for (size_t i = 0; i < _gprims.size(); ++i)
+    {
+        _meshOriginals[i] = i;
+    }
+
+    if (!TfGetEnvSetting(MARI_USD_DEDUPLICATE_MESHES))
+    {
+        _stats.uniqueMeshes = _gprims.size();
+        return;
+    }
+
+    // The topology is cheap to hash, the points at every frame are not:
+    // only the meshes sharing their topology with another one can be
+    // duplicates
+    _stats.hashTimer.Start();
+    vector<MeshHash> hashes(_gprims.size());
+    WorkParallelForN(_gprims.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            hashes[i] = MeshHash::ComputeTopology(_gprims[i].second);
+        }
+    });
+    _stats.meshesHashed = hashes.size();
+
+    map<uint64_t, size_t> topologyCounts;
+    for (const MeshHash &hash : hashes)
+    {
+        if (hash.IsValid())
+            ++topologyCounts[hash.topology];
+    }
+    vector<size_t> candidates;
+    for (size_t i = 0; i < hashes.size(); ++i)
+    {
+        if (hashes[i].IsValid() && topologyCounts[hashes[i].topology] > 1)
+            candidates.push_back(i);
+    }
+    WorkParallelForN(candidates.size(), [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const size_t i = candidates[c];
+            hashes[i].ComputeContent(_gprims[i].second, _options.UVSet, _GetAdditionalUvSets(_gprims[i].second),
+                                     _options.frames);
+        }
+    });
+    _stats.hashTimer.Stop();
+
+    // Meshes that cannot be hashed are left on their own, and so are those
+    // with a topology of their own
+    map<MeshHash, size_t> firstWithHash;
+    size_t unique = 0;
+    for (size_t i = 0; i < hashes.size(); ++i)
+    {
+        if (!hashes[i].IsValid() || topologyCounts[hashes[i].topology] == 1)
+        {
+            ++unique;
             continue;
         }
+        auto inserted = firstWithHash.emplace(hashes[i], i);
+        if (!inserted.second)
+        {
+            _meshOriginals[i] = inserted.first->second;
+            ++_duplicatesLeft[inserted.first->second];
+        }
+    }
+
+    _stats.uniqueMeshes = firstWithHash.size() + unique;
+    MARI_USD_LOG_INFO(_log, "Found %zu distinct meshes among %zu, %zu of them hashed in full",
+                      _stats.uniqueMeshes, hashes.size(), candidates.size());
+}
+
+void
+UsdReader::_DiffAgainstPreviousImport()
+{
+    TRACE_FUNCTION();
 
-        // If we've requested specific gprims and 
-        // this gprim isnt' in that list, continue.
-        // We need to search using the full path of the current
-        // gprim as well as the simple name, since either one
-        // may have been passed in.
-        // XXX This might start to get costly with very large lists of
-        // gprims. 2(O^2). 
+    // "options <hash>" then one "<hash> <path>" line per mesh
+    map<string, MeshHash> previous;
+    string previousOptions;
+    for (const string &line : TfStringSplit(_options.previousMeshHashes, "\n"))
+    {
+        const size_t space = line.find(' ');
+        if (space == string::npos)
+            continue;
+        const string key = line.substr(0, space);
+        const string value = line.substr(space + 1);
+        if (key == "options")
+            previousOptions = value;
+        else
+            previous[value] = MeshHash::FromString(key);
+    }
 
+    if (previous.empty())
+    {
+        MARI_USD_LOG_WARNING(_log, "No mesh hashes saved by a previous import of %s, importing every mesh", _fileName);
+        return;
+    }
+    if (previousOptions != _GetOptionsHash())
+    {
+        MARI_USD_LOG_WARNING(_log, "The import options changed since the previous import of %s, importing every mesh", _fileName);
+        return;
+    }
 
-        //_host.trace("%s:%d] looking for %s and %s in requested names %d.", 
-        //            _pluginName, __LINE__, path.GetName().c_str(), path.GetText(), requestedGprimNames.size());
-        if (
-            requestedGprimNames.size() > 0 &&
-            (std::find(requestedGprimNames.begin(),
-                       requestedGprimNames.end(),
-                       path.GetName()) == requestedGprimNames.end()) &&
-            (std::find(requestedGprimNames.begin(),
-                       requestedGprimNames.end(),
-                       path.GetText()) == requestedGprimNames.end()) 
-            ) 
+    const bool reporting = ImportReport::IsEnabled();
+    for (size_t i = 0; i < _gprims.size(); ++i)
+    {
+        const string path = _gprims[i].second.GetPath().GetString();
+        auto it = previous.find(path);
+        if (it == previous.end())
         {
+            _meshChanges[i] = MeshChange::Added;
+            ++_stats.meshesAdded;
             continue;
         }
 
-        if (currentModelData)
+        const MeshHash &hash = _meshHashes[i];
+        if (hash.IsValid() && hash == it->second)
+        {
+            _meshChanges[i] = MeshChange::Unchanged;
+            ++_stats.meshesUnchanged;
+        }
+        else
+        {
+            _meshChanges[i] = MeshChange::Changed;
+            ++_stats.meshesChanged;
+        }
+        previous.erase(it);
+    }
+
+    _stats.meshesRemoved = previous.size();
+    if (reporting)
+    {
+        vector<string> removed;
+        for (const auto &it : previous)
+        {
+            removed.push_back(it.first);
+        }
+        _report.SetRemovedMeshes(removed);
+    }
+
+    // The unchanged meshes are not extracted: the first mesh left of each
+    // set of duplicates becomes their original
+    vector<size_t> newOriginals(_gprims.size(), _gprims.size());
+    _duplicatesLeft.assign(_gprims.size(), 0);
+    for (size_t i = 0; i < _gprims.size(); ++i)
+    {
+        const size_t original = _meshOriginals[i];
+        if (_meshChanges[i] == MeshChange::Unchanged)
+        {
+            _meshOriginals[i] = i;
+        }
+        else if (newOriginals[original] == _gprims.size())
+        {
+            newOriginals[original] = i;
+            _meshOriginals[i] = i;
+        }
+        else
         {
-            currentModelData->gprims.push_back(*primIt);
-            oneModelLoaded = true;
+            _meshOriginals[i] = newOriginals[original];
+            ++_duplicatesLeft[newOriginals[original]];
         }
+    }
+
+    MARI_USD_LOG_INFO(_log, "Since the previous import: %zu meshes unchanged, %zu changed, %zu added, %zu removed",
+                      _stats.meshesUnchanged, _stats.meshesChanged, _stats.meshesAdded, _stats.meshesRemoved);
+}
 
-        else {
-            _host.trace("[%s] Could not make mari geo entity with uv set %s for"
-                " prim %s", _pluginName, UVSet.c_str(),
-                path.GetString().c_str());
-            _log.push_back("Could not make mari geo entity with uv set "
-                + UVSet + " for prim " + path.GetString() + ".");
+string
+UsdReader::_GetOptionsHash() const
+{
+    // Led by what the mesh hashes are computed from, so that hashes saved
+    // by an earlier version of the plug-in are not compared with these
+    string options = TfStringPrintf("geodata\n%s\n%s\n%s\n%d %d %d %d %d %d %zu", _options.UVSet.c_str(),
+                                    TfStringJoin(_options.additionalUvSets, ",").c_str(), _options.mappingScheme.c_str(),
+                                    int(_options.conformToMariY), int(_options.keepCentered), int(m_upAxisIsY),
+                                    int(_options.generateNormals), int(_options.cleanUp), int(_options.reorderForPainting),
+                                    _options.maxFacesPerObject);
+    for (int frame : _options.frames)
+    {
+        options += TfStringPrintf(" %d", frame);
+    }
+    return TfStringPrintf("%016llx", (unsigned long long)GeoDataKernels::Hash64(options.data(), options.size(), 0));
+}
+
+void
+UsdReader::_SaveMeshHashes(MriGeoEntityHandle &Entity)
+{
+    string hashes = "options " + _GetOptionsHash() + "\n";
+    for (size_t i = 0; i < _gprims.size() && i < _meshHashes.size(); ++i)
+    {
+        if (_meshHashes[i].IsValid())
+        {
+            hashes += _meshHashes[i].ToString() + " " + _gprims[i].second.GetPath().GetString() + "\n";
         }
     }
 
+    MriAttributeValue Value;
+    Value.m_Type = MRI_ATTR_STRING;
+    Value.m_pString = hashes.c_str();
+    _host.setAttribute(Entity, "UsdImportMeshHashes", &Value);
+}
+
+std::vector<std::string>
+UsdReader::_GetAdditionalUvSets(UsdPrim const &prim) const
+{
+    if (_options.additionalUvSets.empty())
+        return std::vector<std::string>();
+    return GeoData::GetAdditionalUvSets(prim, _options.UVSet, _options.additionalUvSets);
+}
+
+std::shared_ptr<GeoData>
+UsdReader::_ExtractMesh(size_t meshIndex, ImportLog &log)
+{
+    const UsdPrim &prim = _gprims[meshIndex].second;
+    const UsdPrim &model = _gprims[meshIndex].first->mprim;
+    const size_t original = _meshOriginals[meshIndex];
+
+    std::shared_ptr<GeoData> geom;
+    if (original == meshIndex)
+    {
+        geom = std::make_shared<GeoData>(prim, _options.UVSet, _GetAdditionalUvSets(prim), _options.mappingScheme, _options.generateNormals, _options.cleanUp, _options.reorderForPainting, _options.frames, _options.conformToMariY, m_upAxisIsY, _options.keepCentered, model, _host, log);
+        if (_duplicatesLeft[meshIndex] > 0)
+        {
+            _originals[meshIndex] = geom;
+        }
+    }
+    else
+    {
+        geom = std::make_shared<GeoData>(_originals[original], prim, _options.frames, _options.conformToMariY, m_upAxisIsY, _options.keepCentered, model, log);
+        if (--_duplicatesLeft[original] == 0)
+        {
+            _originals.erase(original);
+        }
+    }
+    return geom;
+}
+
+MriGeoPluginResult
+UsdReader::_Upload(MriGeoEntityHandle &Entity)
+{
+    TRACE_FUNCTION();
+
+    // Written by _Read, possibly on worker threads
+    _log.FlushTraces();
+
+    if (_readResult != MRI_GPR_SUCCEEDED)
+    {
+        _FinishImport(Entity, _readResult);
+        return _readResult;
+    }
+
+    const bool reporting = ImportReport::IsEnabled();
+    bool keepSeparate = _options.mergeOption=="Keep Models Separate";
+    const bool consolidate = _options.mergeOption == kConsolidateMeshes;
+
+    MriAttributeValue stagePrimValue;
+    stagePrimValue.m_Type = MRI_ATTR_STRING;
+    stagePrimValue.m_pString = _stagePrimPath.c_str();
+    _host.setAttribute(Entity, "StagePrimPath", &stagePrimValue);
+
+    MriAttributeValue uvSetValue;
+    uvSetValue.m_Type = MRI_ATTR_STRING;
+    uvSetValue.m_pString = _options.UVSet.c_str();
+    _host.setAttribute(Entity, "UvSetName", &uvSetValue);
+
+    // On re-import, models with no changed mesh are left out
+    auto modelUnchanged = [this](size_t firstMesh, size_t numMeshes)
+    {
+        for (size_t i = firstMesh; i < firstMesh + numMeshes; ++i)
+        {
+            if (_meshChanges[i] != MeshChange::Unchanged)
+                return false;
+        }
+        return true;
+    };
+
     int modelCount = 0;
-    for (ModelData* modelData: modelDataList)
+    size_t firstMesh = 0;
+    for (ModelData* modelData: _modelDataList)
     {
-        if (modelData->gprims.size()>0)
+        if (modelData->gprims.size()>0 && !modelUnchanged(firstMesh, modelData->gprims.size()))
         {
             ++modelCount;
         }
-    }
-
-    if (modelCount == 0)
-    {
-        // No UsdGeomMesh found to load -> error out now!
-
-        _host.trace("[%s:%d] No model of type UsdGeomMesh found to load in %s", _pluginName, __LINE__, _fileName);
-        _log.push_back("> No model of type UsdGeomMesh found to load in " + std::string(_fileName));
-
-        return MRI_GPR_FAILED;
+        firstMesh += modelData->gprims.size();
     }
 
     bool createChildren = modelCount>1 && keepSeparate;
@@ -345,9 +1070,12 @@ UsdReader::Load(MriGeoEntityHandle &Entity)
     if (createChildren)
     {
         _host.setEntityType(Entity, MRI_SET_ENTITY);
+        ++_stats.hostCalls;
     }
 
-    for (ModelData* modelData: modelDataList)
+    TRACE_SCOPE("UsdReader: extract and upload");
+    size_t meshIndex = 0;
+    for (ModelData* modelData: _modelDataList)
     {
         if (modelData->gprims.size()==0)
         {
@@ -355,25 +1083,95 @@ UsdReader::Load(MriGeoEntityHandle &Entity)
             continue;
         }
 
+        if (modelUnchanged(meshIndex, modelData->gprims.size()))
+        {
+            meshIndex += modelData->gprims.size();
+            continue;
+        }
+
         MriGeoEntityHandle entityToPopulate = Entity;
         if (createChildren)
         {
             MriGeoEntityHandle childEntity;
             _host.createChildGeoEntity(Entity, _fileName, &childEntity);
             _host.setEntityName(childEntity, modelData->instanceName.c_str());
+            _stats.hostCalls += 2;
 
             entityToPopulate = childEntity; 
+            _topologyFingerprints.clear();
+        }
+
+        if (reporting)
+        {
+            ImportReport::Model model;
+            model.name = modelData->instanceName;
+            model.path = modelData->mprim.GetPath().GetString();
+            model.gprims = modelData->gprims.size();
+            _report.AddModel(model);
         }
 
         bool ValidEntity = false;
+        std::vector<PendingMesh> pendingMeshes;
         for (auto prim: modelData->gprims)
         {
-            // Create a mari-compatible geometry
-            GeoData Geom(prim, UVSet, mappingScheme, frames, conformToMariY, m_upAxisIsY, keepCentered, modelData->mprim, _host, _log);
-            if (Geom)
+            // Written while extracting and uploading the previous mesh
+            _log.FlushTraces();
+
+            if (_meshChanges[meshIndex] == MeshChange::Unchanged)
+            {
+                ++meshIndex;
+                continue;
+            }
+
+            // Create a mari-compatible geometry, unless _Extract already did.
+            // The report gets the warnings of the mesh from a log of its own,
+            // which the limit of _log does not apply to.
+            std::shared_ptr<GeoData> geom;
+            std::vector<std::string> meshWarnings;
+            if (meshIndex < _extracted.size())
+            {
+                geom = std::move(_extracted[meshIndex]);
+                if (meshIndex < _extractedWarnings.size())
+                    meshWarnings = std::move(_extractedWarnings[meshIndex]);
+            }
+            else
             {
-                _host.trace("[%s:%d] * Found importable mesh %s", _pluginName, __LINE__, prim.GetPath().GetName().c_str());
+                ImportLog meshLog(_log);
+                _stats.extractTimer.Start();
+                geom = _ExtractMesh(meshIndex, reporting ? meshLog : _log);
+                _stats.extractTimer.Stop();
+                if (reporting)
+                    meshWarnings = meshLog.GetMessages();
+
+                // A patch hashed every mesh already
+                if (!_options.changedMeshesOnly)
+                {
+                    _stats.hashTimer.Start();
+                    _meshHashes[meshIndex] = MeshHash::FromGeoData(*geom, _options.frames);
+                    _stats.hashTimer.Stop();
+                }
+            }
+            const size_t original = _meshOriginals[meshIndex];
+            const MeshChange change = _meshChanges[meshIndex];
+            ++meshIndex;
+            GeoData &Geom = *geom;
+
+            ImportReport::Mesh reportMesh;
+            if (reporting)
+            {
+                reportMesh.path = prim.GetPath().GetString();
+                reportMesh.model = modelData->instanceName;
+                reportMesh.warnings = std::move(meshWarnings);
+                if (Geom.SharesChannels())
+                    reportMesh.duplicateOf = _gprims[original].second.GetPath().GetString();
+                if (change == MeshChange::Changed)
+                    reportMesh.change = "changed";
+                else if (change == MeshChange::Added)
+                    reportMesh.change = "added";
+            }
 
+            if (Geom)
+            {
                 // detect handle id
                 std::string handle = "";
                 TfToken orientation;
@@ -402,15 +1200,65 @@ UsdReader::Load(MriGeoEntityHandle &Entity)
                 orientationValue.m_Int = orientation==TfToken("leftHanded");
                 _host.setAttribute(entityToPopulate, "MriGeoEntityReverseOrientation", &orientationValue);
 
-                _MakeGeoEntity(Geom, entityToPopulate, handle, frames, createFaceSelectionGroups);
+                if (reporting)
+                {
+                    reportMesh.faces = Geom.GetNumFaceVertexCounts();
+                    reportMesh.points = Geom.GetNumPoints() / 3;
+                    reportMesh.hasUVs = Geom.HasUVs();
+                    reportMesh.hasNormals = Geom.HasNormals();
+                    reportMesh.isSubdiv = Geom.IsSubdivMesh();
+                    reportMesh.topology = Geom.GetTopologyFingerprintString();
+                    reportMesh.removedPoints = Geom.GetNumRemovedPoints();
+                    reportMesh.removedFaces = Geom.GetNumRemovedFaces();
+                    if (Geom.HasUVs())
+                        reportMesh.udimTiles = _FormatUdimTiles(Geom.GetUdimTiles());
+                }
 
                 ValidEntity = true;
+
+                if (consolidate)
+                {
+                    // Uploaded with the rest of the model below
+                    pendingMeshes.push_back(PendingMesh{std::move(geom), handle, std::move(reportMesh)});
+                    continue;
+                }
+
+                _stats.uploadTimer.Start();
+                size_t meshObjects = 0;
+                if (_MakeGeoEntities(Geom, entityToPopulate, handle, _options.frames, _options.createFaceSelectionGroups, meshObjects) == MRI_GPR_SUCCEEDED)
+                {
+                    ++_stats.meshesImported;
+                    _stats.meshObjects += meshObjects;
+                    reportMesh.meshObjects = meshObjects;
+                    if (Geom.SharesChannels())
+                        ++_stats.meshesDeduplicated;
+                    _stats.faces += Geom.GetNumFaceVertexCounts();
+                    _stats.points += Geom.GetNumPoints() / 3;
+                    reportMesh.imported = true;
+                }
+                else
+                {
+                    _stats.RejectMesh("host rejected geometry");
+                    _log.Count("meshes discarded", "host rejected geometry");
+                    reportMesh.rejectReason = "host rejected geometry";
+                }
+                _stats.uploadTimer.Stop();
             }
             else
             {
-                _host.trace("[%s:%d] X Could not load mesh %s", _pluginName, __LINE__, prim.GetPath().GetName().c_str());
+                reportMesh.rejectReason = Geom.GetRejectReason().empty() ? "empty mesh" : Geom.GetRejectReason();
+                _stats.RejectMesh(reportMesh.rejectReason);
+                _log.Count("meshes discarded", reportMesh.rejectReason);
                 --modelCount;
             }
+
+            if (reporting)
+                _report.AddMesh(std::move(reportMesh));
+        }
+
+        if (!pendingMeshes.empty())
+        {
+            _UploadConsolidated(pendingMeshes, entityToPopulate, modelData->instanceName);
         }
 
         // Save on metadata file
@@ -418,29 +1266,171 @@ UsdReader::Load(MriGeoEntityHandle &Entity)
         {
             _SaveMetadata( Entity, *modelData);
         }
+        if (createChildren)
+        {
+            _SaveTopologyFingerprints(entityToPopulate);
+            _SaveFaceSources(entityToPopulate);
+            _SaveUdimTiles(entityToPopulate);
+        }
+    }
+    if (!createChildren)
+    {
+        _SaveTopologyFingerprints(Entity);
+        _SaveFaceSources(Entity);
+        _SaveUdimTiles(Entity);
     }
+    _extracted.clear();
+    _extractedWarnings.clear();
+    _originals.clear();
+
+    _SaveMeshHashes(Entity);
 
     MriGeoPluginResult result = MRI_GPR_SUCCEEDED;
 
-    if (modelDataList.size()==0 or modelCount == 0)
+    if (_stats.meshesUnchanged > 0 && _stats.meshesUnchanged == _gprims.size())
     {
-        _host.trace("[%s:%d] No valid geometry found in %s", _pluginName, __LINE__, _fileName);
-        _log.push_back("> No valid geometry found in " + std::string(_fileName));
+        // An empty patch: the previous import is up to date
+        MARI_USD_LOG_INFO(_log, "> No mesh changed since the previous import of %s, the patch is empty", _fileName);
+    }
+    else if (_modelDataList.size()==0 or modelCount == 0)
+    {
+        MARI_USD_LOG_ERROR(_log, "> No valid geometry found in %s", _fileName);
 
         result = MRI_GPR_FAILED;
     }
 
-    // clean up
-    for(ModelData* modelData: modelDataList)
-    {
-        delete modelData;
-    }
+    MARI_USD_LOG_INFO(_log, "Import of %s took %.3f s (cpu)", _fileName,
+                      double(clock() - _startTime) / CLOCKS_PER_SEC);
+
+    _FinishImport(Entity, result);
 
     return result;
 }
 
 
 
+void
+UsdReader::_UploadConsolidated(std::vector<PendingMesh> &meshes,
+                               MriGeoEntityHandle &Entity,
+                               const std::string &modelName)
+{
+    TRACE_FUNCTION();
+
+    const bool reporting = ImportReport::IsEnabled();
+
+    // Group the meshes that can be concatenated, in the order they were found
+    std::vector<std::string> keys;
+    std::map<std::string, std::vector<size_t> > groups;
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const std::string key = meshes[i].geom->GetConsolidationKey();
+        std::vector<size_t> &group = groups[key];
+        if (group.empty())
+        {
+            keys.push_back(key);
+        }
+        group.push_back(i);
+    }
+
+    int batchCount = 0;
+    for (const std::string &key : keys)
+    {
+        const std::vector<size_t> &group = groups[key];
+        size_t begin = 0;
+        while (begin < group.size())
+        {
+            // Close the batch before it outgrows the limits. A mesh over
+            // them on its own still gets a batch, which splits it.
+            const size_t maxFaces = _options.maxFacesPerObject > 0 ?
+                std::min(kMaxConsolidatedFaces, _options.maxFacesPerObject) : kMaxConsolidatedFaces;
+            size_t end = begin;
+            size_t faces = 0;
+            size_t faceVertices = 0;
+            size_t points = 0;
+            while (end < group.size())
+            {
+                GeoData &geom = *meshes[group[end]].geom;
+                const size_t meshFaces = geom.GetNumFaceVertexCounts();
+                const size_t meshFaceVertices = geom.GetNumVertexIndices();
+                if (end > begin && (faces + meshFaces > maxFaces ||
+                                    faceVertices + meshFaceVertices > kMaxFaceVerticesPerObject))
+                    break;
+                faces += meshFaces;
+                faceVertices += meshFaceVertices;
+                points += geom.GetNumPoints() / 3;
+                ++end;
+            }
+
+            MriGeoPluginResult result;
+            size_t meshObjects = 1;
+            if (end - begin == 1)
+            {
+                PendingMesh &mesh = meshes[group[begin]];
+                _stats.uploadTimer.Start();
+                result = _MakeGeoEntities(*mesh.geom, Entity, mesh.handle, _options.frames, _options.createFaceSelectionGroups, meshObjects);
+                _stats.uploadTimer.Stop();
+                mesh.reportMesh.meshObjects = meshObjects;
+            }
+            else
+            {
+                std::vector<GeoData*> sources;
+                std::vector<std::string> labels;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    sources.push_back(meshes[group[i]].geom.get());
+                    labels.push_back(meshes[group[i]].handle);
+                }
+                _stats.extractTimer.Start();
+                GeoData batch(sources, labels);
+                _stats.extractTimer.Stop();
+
+                const std::string label = TfStringPrintf("%s_consolidated%d", modelName.c_str(), batchCount);
+                _stats.uploadTimer.Start();
+                result = _MakeGeoEntity(batch, Entity, label, _options.frames, _options.createFaceSelectionGroups);
+                _selectionGroups.clear();
+                _stats.uploadTimer.Stop();
+            }
+            ++batchCount;
+
+            if (result == MRI_GPR_SUCCEEDED)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    if (meshes[group[i]].geom->SharesChannels())
+                        ++_stats.meshesDeduplicated;
+                }
+                _stats.meshObjects += meshObjects;
+                _stats.meshesImported += end - begin;
+                _stats.faces += faces;
+                _stats.points += points;
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                PendingMesh &mesh = meshes[group[i]];
+                mesh.geom.reset();
+                if (result == MRI_GPR_SUCCEEDED)
+                {
+                    mesh.reportMesh.imported = true;
+                }
+                else
+                {
+                    _stats.RejectMesh("host rejected geometry");
+                    _log.Count("meshes discarded", "host rejected geometry");
+                    mesh.reportMesh.rejectReason = "host rejected geometry";
+                }
+                if (reporting)
+                    _report.AddMesh(std::move(mesh.reportMesh));
+            }
+
+            begin = end;
+        }
+    }
+
+    MARI_USD_LOG_INFO(_log, "Consolidated %zu meshes of %s into %d mesh objects",
+                      meshes.size(), modelName.c_str(), batchCount);
+}
+
 void 
 UsdReader::_GetFrameList(const string &frameString, vector<int> &frames)
 {
@@ -494,6 +1484,8 @@ UsdReader::_GetVariantSelectionsList(const string &variantsString, vector<SdfPat
 
 MriGeoPluginResult UsdReader::_MakeGeoEntity(GeoData &Geom, MriGeoEntityHandle &Entity, string label, const vector<int> &frames, bool createFaceSelectionGroups)
 {
+    TRACE_FUNCTION();
+
     MriGeoDataHandle FaceVertexCounts, Vertices, Normals, VertexIndices, NormalIndices;
     MriGeoDataHandle UVs, UVIndices;
     MriGeoDataHandle CreaseIndices, CreaseLengths, CreaseSharpness, CornerIndices, CornerSharpness, Holes;
@@ -503,267 +1495,359 @@ MriGeoPluginResult UsdReader::_MakeGeoEntity(GeoData &Geom, MriGeoEntityHandle &
     // 1 Create a version - not needed, as Mari creates a default one for us
 
     // 2. Create our geometry data channels
-    CHECK_RESULT(_host.createGeoData(Entity,
-                                     Geom.GetVertices(0),
-                                     Geom.GetNumPoints() * sizeof(float),
-                                     MRI_GDT_FLOAT_BUFFER,
-                                     MRI_GDR_MESH_VERTICES,
-                                     &Vertices));
-    CHECK_RESULT(_host.createGeoData(Entity,
-                                     Geom.GetVertexIndices(),
-                                     Geom.GetNumVertexIndices() * sizeof(unsigned int),
-                                     MRI_GDT_U32_BUFFER,
-                                     MRI_GDR_MESH_VERTEX_INDICES,
-                                     &VertexIndices));
-    CHECK_RESULT(_host.createGeoData(Entity,
-                                     Geom.GetFaceVertexCounts(),
-                                     Geom.GetNumFaceVertexCounts() * sizeof(unsigned int),
-                                     MRI_GDT_U32_BUFFER,
-                                     MRI_GDR_MESH_FACE_VERTEX_COUNTS,
-                                     &FaceVertexCounts));
+    CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                   Geom.GetVertices(0),
+                                   Geom.GetNumPoints() * sizeof(float),
+                                   MRI_GDT_FLOAT_BUFFER,
+                                   MRI_GDR_MESH_VERTICES,
+                                   &Vertices));
+    CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                   Geom.GetVertexIndices(),
+                                   Geom.GetNumVertexIndices() * sizeof(unsigned int),
+                                   MRI_GDT_U32_BUFFER,
+                                   MRI_GDR_MESH_VERTEX_INDICES,
+                                   &VertexIndices));
+    CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                   Geom.GetFaceVertexCounts(),
+                                   Geom.GetNumFaceVertexCounts() * sizeof(unsigned int),
+                                   MRI_GDT_U32_BUFFER,
+                                   MRI_GDR_MESH_FACE_VERTEX_COUNTS,
+                                   &FaceVertexCounts));
 
     if (Geom.HasNormals())
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetNormals(),
-                                         Geom.GetNumNormals() * sizeof(float),
-                                         MRI_GDT_FLOAT_BUFFER,
-                                         MRI_GDR_MESH_NORMALS,
-                                         &Normals));
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetNormalIndices(),
-                                         Geom.GetNumVertexIndices() * sizeof(unsigned int),
-                                         MRI_GDT_U32_BUFFER,
-                                         MRI_GDR_MESH_NORMAL_INDICES,
-                                         &NormalIndices));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetNormals(0),
+                                       Geom.GetNumNormals() * sizeof(float),
+                                       MRI_GDT_FLOAT_BUFFER,
+                                       MRI_GDR_MESH_NORMALS,
+                                       &Normals));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetNormalIndices(),
+                                       Geom.GetNumVertexIndices() * sizeof(unsigned int),
+                                       MRI_GDT_U32_BUFFER,
+                                       MRI_GDR_MESH_NORMAL_INDICES,
+                                       &NormalIndices));
     }
     if (Geom.HasUVs())
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetUVs(),
-                                         Geom.GetNumUvs() * sizeof(float),
-                                         MRI_GDT_FLOAT_BUFFER,
-                                         MRI_GDR_MESH_UV0,
-                                         &UVs));
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetUVIndices(),
-                                         Geom.GetNumVertexIndices() * sizeof(unsigned int),
-                                         MRI_GDT_U32_BUFFER,
-                                         MRI_GDR_MESH_UV0_INDICES,
-                                         &UVIndices));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetUVs(),
+                                       Geom.GetNumUvs() * sizeof(float),
+                                       MRI_GDT_FLOAT_BUFFER,
+                                       MRI_GDR_MESH_UV0,
+                                       &UVs));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetUVIndices(),
+                                       Geom.GetNumVertexIndices() * sizeof(unsigned int),
+                                       MRI_GDT_U32_BUFFER,
+                                       MRI_GDR_MESH_UV0_INDICES,
+                                       &UVIndices));
     }
 
     if (Geom.GetNumCreaseIndices() > 0)
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetCreaseLengths(),
-                                         Geom.GetNumCreaseLengths() * sizeof(unsigned int),
-                                         MRI_GDT_U32_BUFFER,
-                                         MRI_GDR_MESH_SUBD_CREASE_LENGTHS,
-                                         &CreaseLengths));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetCreaseLengths(),
+                                       Geom.GetNumCreaseLengths() * sizeof(unsigned int),
+                                       MRI_GDT_U32_BUFFER,
+                                       MRI_GDR_MESH_SUBD_CREASE_LENGTHS,
+                                       &CreaseLengths));
     }
     if (Geom.GetNumCreaseLengths() > 0)
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetCreaseIndices(),
-                                         Geom.GetNumCreaseIndices() * sizeof(unsigned int),
-                                         MRI_GDT_U32_BUFFER,
-                                         MRI_GDR_MESH_SUBD_CREASE_INDICES,
-                                         &CreaseIndices));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetCreaseIndices(),
+                                       Geom.GetNumCreaseIndices() * sizeof(unsigned int),
+                                       MRI_GDT_U32_BUFFER,
+                                       MRI_GDR_MESH_SUBD_CREASE_INDICES,
+                                       &CreaseIndices));
     }
     if (Geom.GetNumCreaseSharpness() > 0)
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetCreaseSharpness(),
-                                         Geom.GetNumCreaseSharpness() * sizeof(float),
-                                         MRI_GDT_FLOAT_BUFFER,
-                                         MRI_GDR_MESH_SUBD_CREASE_SHARPNESS,
-                                         &CreaseSharpness));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetCreaseSharpness(),
+                                       Geom.GetNumCreaseSharpness() * sizeof(float),
+                                       MRI_GDT_FLOAT_BUFFER,
+                                       MRI_GDR_MESH_SUBD_CREASE_SHARPNESS,
+                                       &CreaseSharpness));
     }
     if (Geom.GetNumCornerIndices() > 0)
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetCornerIndices(),
-                                         Geom.GetNumCornerIndices() * sizeof(unsigned int),
-                                         MRI_GDT_U32_BUFFER,
-                                         MRI_GDR_MESH_SUBD_CORNER_INDICES,
-                                         &CornerIndices));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetCornerIndices(),
+                                       Geom.GetNumCornerIndices() * sizeof(unsigned int),
+                                       MRI_GDT_U32_BUFFER,
+                                       MRI_GDR_MESH_SUBD_CORNER_INDICES,
+                                       &CornerIndices));
     }
     if (Geom.GetNumCornerSharpness() > 0)
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetCornerSharpness(),
-                                         Geom.GetNumCornerSharpness() * sizeof(float),
-                                         MRI_GDT_FLOAT_BUFFER,
-                                         MRI_GDR_MESH_SUBD_CORNER_SHARPNESS,
-                                         &CornerSharpness));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetCornerSharpness(),
+                                       Geom.GetNumCornerSharpness() * sizeof(float),
+                                       MRI_GDT_FLOAT_BUFFER,
+                                       MRI_GDR_MESH_SUBD_CORNER_SHARPNESS,
+                                       &CornerSharpness));
     }
     if (Geom.GetNumHoleIndices() > 0)
     {
-        CHECK_RESULT(_host.createGeoData(Entity,
-                                         Geom.GetHoleIndicess(),
-                                         Geom.GetNumHoleIndices() * sizeof(unsigned int),
-                                         MRI_GDT_U32_BUFFER,
-                                         MRI_GDR_MESH_SUBD_HOLES,
-                                         &Holes));
+        CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                       Geom.GetHoleIndicess(),
+                                       Geom.GetNumHoleIndices() * sizeof(unsigned int),
+                                       MRI_GDT_U32_BUFFER,
+                                       MRI_GDR_MESH_SUBD_HOLES,
+                                       &Holes));
     }
 
     // 3. Create Mesh and add data channels to it
-    CHECK_RESULT(_host.createMeshObject(Entity, label.c_str(), Geom.GetNumFaceVertexCounts(), &MeshObject));
-    CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, Vertices));
-    CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, VertexIndices));
+    CHECK_HOST_CALL(_host.createMeshObject(Entity, label.c_str(), Geom.GetNumFaceVertexCounts(), &MeshObject));
+    CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, Vertices));
+    CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, VertexIndices));
     if (Geom.HasNormals())
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, Normals));
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, NormalIndices));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, Normals));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, NormalIndices));
     }
-    CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, FaceVertexCounts));
+    CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, FaceVertexCounts));
     if (Geom.HasUVs())
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, UVs));
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, UVIndices));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, UVs));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, UVIndices));
     }
 
     if (Geom.GetNumCreaseIndices() > 0)
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, CreaseIndices));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, CreaseIndices));
     }
     if (Geom.GetNumCreaseLengths() > 0)
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, CreaseLengths));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, CreaseLengths));
     }
     if (Geom.GetNumCreaseSharpness() > 0)
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, CreaseSharpness));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, CreaseSharpness));
     }
     if (Geom.GetNumCornerIndices() > 0)
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, CornerIndices));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, CornerIndices));
     }
     if (Geom.GetNumCornerSharpness() > 0)
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, CornerSharpness));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, CornerSharpness));
     }
     if (Geom.GetNumHoleIndices() > 0)
     {
-        CHECK_RESULT(_host.addGeoDataToObject(Entity, MeshObject, Holes));
+        CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, MeshObject, Holes));
     }
     if (Geom.IsSubdivMesh())
     {
-        CHECK_RESULT(_host.setSubdivisionOnMeshObject(Entity,
-                                                      MeshObject,
-                                                      Geom.SubdivisionScheme().c_str(),
-                                                      Geom.InterpolateBoundary(),
-                                                      Geom.FaceVaryingLinearInterpolation(),
-                                                      Geom.PropagateCorner(),
-                                                      Geom.TriangleSubdivision()));
+        CHECK_HOST_CALL(_host.setSubdivisionOnMeshObject(Entity,
+                                                         MeshObject,
+                                                         Geom.SubdivisionScheme().c_str(),
+                                                         Geom.InterpolateBoundary(),
+                                                         Geom.FaceVaryingLinearInterpolation(),
+                                                         Geom.PropagateCorner(),
+                                                         Geom.TriangleSubdivision()));
+    }
+
+    // 3b. One more mesh object per additional uv set, sharing every channel
+    // of the first one but the uvs. Uv indices identical to those of an
+    // earlier set share its handle.
+    const std::vector<GeoData::AdditionalUvSet> &additionalUvSets = Geom.GetAdditionalUvSets();
+    std::vector<MriGeoDataHandle> AdditionalUVs(additionalUvSets.size());
+    std::vector<MriGeoDataHandle> AdditionalUVIndices(additionalUvSets.size());
+    if (!additionalUvSets.empty())
+    {
+        std::vector<MriGeoDataHandle> sharedChannels = {Vertices, VertexIndices, FaceVertexCounts};
+        if (Geom.HasNormals())
+        {
+            sharedChannels.push_back(Normals);
+            sharedChannels.push_back(NormalIndices);
+        }
+        if (Geom.GetNumCreaseIndices() > 0)
+            sharedChannels.push_back(CreaseIndices);
+        if (Geom.GetNumCreaseLengths() > 0)
+            sharedChannels.push_back(CreaseLengths);
+        if (Geom.GetNumCreaseSharpness() > 0)
+            sharedChannels.push_back(CreaseSharpness);
+        if (Geom.GetNumCornerIndices() > 0)
+            sharedChannels.push_back(CornerIndices);
+        if (Geom.GetNumCornerSharpness() > 0)
+            sharedChannels.push_back(CornerSharpness);
+        if (Geom.GetNumHoleIndices() > 0)
+            sharedChannels.push_back(Holes);
+
+        for (size_t set = 0; set < additionalUvSets.size(); ++set)
+        {
+            const GeoData::AdditionalUvSet &uvSet = additionalUvSets[set];
+            CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                           uvSet.uvs.data(),
+                                           uvSet.uvs.size() * sizeof(float),
+                                           MRI_GDT_FLOAT_BUFFER,
+                                           MRI_GDR_MESH_UV0,
+                                           &AdditionalUVs[set]));
+            if (uvSet.indicesOf < 0)
+            {
+                CHECK_HOST_CALL(_CreateGeoData(Entity,
+                                               uvSet.indices.data(),
+                                               Geom.GetNumVertexIndices() * sizeof(unsigned int),
+                                               MRI_GDT_U32_BUFFER,
+                                               MRI_GDR_MESH_UV0_INDICES,
+                                               &AdditionalUVIndices[set]));
+            }
+            else
+            {
+                AdditionalUVIndices[set] = uvSet.indicesOf == 0 ? UVIndices : AdditionalUVIndices[uvSet.indicesOf - 1];
+            }
+
+            MriGeoObjectHandle UvSetObject;
+            const std::string uvSetLabel = label + "_" + uvSet.name;
+            CHECK_HOST_CALL(_host.createMeshObject(Entity, uvSetLabel.c_str(), Geom.GetNumFaceVertexCounts(), &UvSetObject));
+            for (MriGeoDataHandle channel : sharedChannels)
+            {
+                CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, UvSetObject, channel));
+            }
+            CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, UvSetObject, AdditionalUVs[set]));
+            CHECK_HOST_CALL(_host.addGeoDataToObject(Entity, UvSetObject, AdditionalUVIndices[set]));
+            if (Geom.IsSubdivMesh())
+            {
+                CHECK_HOST_CALL(_host.setSubdivisionOnMeshObject(Entity,
+                                                                 UvSetObject,
+                                                                 Geom.SubdivisionScheme().c_str(),
+                                                                 Geom.InterpolateBoundary(),
+                                                                 Geom.FaceVaryingLinearInterpolation(),
+                                                                 Geom.PropagateCorner(),
+                                                                 Geom.TriangleSubdivision()));
+            }
+            ++_stats.meshObjects;
+        }
     }
 
     // Load animated frames
     // The structures before have added a default entry in the channels' data refererences with frame=0
     for (unsigned int frameIndex = 0; frameIndex<frames.size(); ++frameIndex)
     {
+        TRACE_SCOPE("UsdReader: set animated frame");
         int frame = frames[frameIndex];
         if (frame == 0)
         {
             // We've already added ddi references for frame = 0, no need to do that again - Skip
             continue;
         }
-
-        CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                              Vertices,
-                                              frame,
-                                              Geom.GetVertices(frame),
-                                              Geom.GetNumPoints() * sizeof(float)));
-
-        CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                              VertexIndices,
-                                              frame,
-                                              Geom.GetVertexIndices(),
-                                              Geom.GetNumVertexIndices() * sizeof(unsigned int)));
-
-        CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                              FaceVertexCounts,
-                                              frame,
-                                              Geom.GetFaceVertexCounts(),
-                                              Geom.GetNumFaceVertexCounts() * sizeof(unsigned)))
+        ++_stats.frames;
+
+        CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                            Vertices,
+                                            frame,
+                                            Geom.GetVertices(frame),
+                                            Geom.GetNumPoints() * sizeof(float)));
+
+        CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                            VertexIndices,
+                                            frame,
+                                            Geom.GetVertexIndices(),
+                                            Geom.GetNumVertexIndices() * sizeof(unsigned int)));
+
+        CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                            FaceVertexCounts,
+                                            frame,
+                                            Geom.GetFaceVertexCounts(),
+                                            Geom.GetNumFaceVertexCounts() * sizeof(unsigned)))
         if (Geom.HasNormals())
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  Normals,
-                                                  frame,
-                                                  Geom.GetNormals(),
-                                                  Geom.GetNumNormals() * sizeof(float)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                Normals,
+                                                frame,
+                                                Geom.GetNormals(frame),
+                                                Geom.GetNumNormals() * sizeof(float)));
 
             // REQUIRED To prevent Mari from automatically reindexing for latter frames and creating mangled rendereing
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  NormalIndices,
-                                                  frame,
-                                                  Geom.GetNormalIndices(),
-                                                  Geom.GetNumVertexIndices() * sizeof(unsigned int)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                NormalIndices,
+                                                frame,
+                                                Geom.GetNormalIndices(),
+                                                Geom.GetNumVertexIndices() * sizeof(unsigned int)));
         }
         if (Geom.HasUVs())
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  UVs,
-                                                  frame,
-                                                  Geom.GetUVs(),
-                                                  Geom.GetNumUvs() * sizeof(float)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                UVs,
+                                                frame,
+                                                Geom.GetUVs(),
+                                                Geom.GetNumUvs() * sizeof(float)));
             // REQUIRED To prevent Mari from automatically reindexing for latter frames and creating mangled rendereing
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  UVIndices,
-                                                  frame,
-                                                  Geom.GetUVIndices(),
-                                                  Geom.GetNumVertexIndices() * sizeof(unsigned int)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                UVIndices,
+                                                frame,
+                                                Geom.GetUVIndices(),
+                                                Geom.GetNumVertexIndices() * sizeof(unsigned int)));
+        }
+        for (size_t set = 0; set < additionalUvSets.size(); ++set)
+        {
+            const GeoData::AdditionalUvSet &uvSet = additionalUvSets[set];
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                AdditionalUVs[set],
+                                                frame,
+                                                uvSet.uvs.data(),
+                                                uvSet.uvs.size() * sizeof(float)));
+            if (uvSet.indicesOf < 0)
+            {
+                CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                    AdditionalUVIndices[set],
+                                                    frame,
+                                                    uvSet.indices.data(),
+                                                    Geom.GetNumVertexIndices() * sizeof(unsigned int)));
+            }
         }
 
         if (Geom.GetNumCreaseIndices() > 0)
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  CreaseLengths,
-                                                  frame,
-                                                  Geom.GetCreaseLengths(),
-                                                  Geom.GetNumCreaseLengths() * sizeof(unsigned int)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                CreaseLengths,
+                                                frame,
+                                                Geom.GetCreaseLengths(),
+                                                Geom.GetNumCreaseLengths() * sizeof(unsigned int)));
         }
         if (Geom.GetNumCreaseLengths() > 0)
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  CreaseIndices,
-                                                  frame,
-                                                  Geom.GetCreaseIndices(),
-                                                  Geom.GetNumCreaseIndices() * sizeof(unsigned int)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                CreaseIndices,
+                                                frame,
+                                                Geom.GetCreaseIndices(),
+                                                Geom.GetNumCreaseIndices() * sizeof(unsigned int)));
         }
         if (Geom.GetNumCreaseSharpness() > 0)
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  CreaseSharpness,
-                                                  frame,
-                                                  Geom.GetCreaseSharpness(),
-                                                  Geom.GetNumCreaseSharpness() * sizeof(float)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                CreaseSharpness,
+                                                frame,
+                                                Geom.GetCreaseSharpness(),
+                                                Geom.GetNumCreaseSharpness() * sizeof(float)));
         }
         if (Geom.GetNumCornerIndices() > 0)
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  CornerIndices,
-                                                  frame,
-                                                  Geom.GetCornerIndices(),
-                                                  Geom.GetNumCornerIndices() * sizeof(unsigned int)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                CornerIndices,
+                                                frame,
+                                                Geom.GetCornerIndices(),
+                                                Geom.GetNumCornerIndices() * sizeof(unsigned int)));
         }
         if (Geom.GetNumCornerSharpness() > 0)
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  CornerSharpness,
-                                                  frame,
-                                                  Geom.GetCornerSharpness(),
-                                                  Geom.GetNumCornerSharpness() * sizeof(float)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                CornerSharpness,
+                                                frame,
+                                                Geom.GetCornerSharpness(),
+                                                Geom.GetNumCornerSharpness() * sizeof(float)));
         }
         if (Geom.GetNumHoleIndices() > 0)
         {
-            CHECK_RESULT(_host.setGeoDataForFrame(Entity,
-                                                  Holes,
-                                                  frame,
-                                                  Geom.GetHoleIndicess(),
-                                                  Geom.GetNumHoleIndices() * sizeof(unsigned int)));
+            CHECK_HOST_CALL(_SetGeoDataForFrame(Entity,
+                                                Holes,
+                                                frame,
+                                                Geom.GetHoleIndicess(),
+                                                Geom.GetNumHoleIndices() * sizeof(unsigned int)));
         }
     }
 
@@ -774,16 +1858,108 @@ MriGeoPluginResult UsdReader::_MakeGeoEntity(GeoData &Geom, MriGeoEntityHandle &
     {
         char pszBuffer[256];
 
+        // The parts of a split mesh add their faces to the same group
+        auto faceSelection = [&](MriSelectionGroupHandle &FaceSelection) -> MriGeoPluginResult
+        {
+            auto it = _selectionGroups.find(pszBuffer);
+            if (it != _selectionGroups.end())
+            {
+                FaceSelection = it->second;
+                return MRI_GPR_SUCCEEDED;
+            }
+            MriGeoPluginResult result = _host.createSelectionGroup(Entity, pszBuffer, &FaceSelection);
+            if (result == MRI_GPR_SUCCEEDED)
+                _selectionGroups[pszBuffer] = FaceSelection;
+            return result;
+        };
+
         MriSelectionGroupHandle FaceSelection;
 
-        snprintf(pszBuffer, sizeof(pszBuffer), "Faces_%s", label.c_str());
-        CHECK_RESULT(_host.createSelectionGroup(Entity, pszBuffer, &FaceSelection));
-        CHECK_RESULT(_host.addFacesToSelectionGroup(Entity, FaceSelection, MeshObject, Geom.GetFaceSelectionIndices(), Geom.GetNumFaceVertexCounts()));
+        if (Geom.GetSourceRanges().empty())
+        {
+            snprintf(pszBuffer, sizeof(pszBuffer), "Faces_%s", label.c_str());
+            CHECK_HOST_CALL(faceSelection(FaceSelection));
+            CHECK_HOST_CALL(_host.addFacesToSelectionGroup(Entity, FaceSelection, MeshObject, Geom.GetFaceSelectionIndices(), Geom.GetNumFaceVertexCounts()));
+        }
+        else
+        {
+            // One group per consolidated mesh, over the faces it brought in
+            for (const GeoData::SourceRange &range : Geom.GetSourceRanges())
+            {
+                snprintf(pszBuffer, sizeof(pszBuffer), "Faces_%s", range.label.c_str());
+                CHECK_HOST_CALL(faceSelection(FaceSelection));
+                CHECK_HOST_CALL(_host.addFacesToSelectionGroup(Entity, FaceSelection, MeshObject, Geom.GetFaceSelectionIndices() + range.firstFace, range.numFaces));
+            }
+        }
+    }
+
+    _topologyFingerprints.push_back(std::make_pair(label, Geom.GetTopologyFingerprint()));
+
+    // Where the faces come from, if they were cleaned up or reordered
+    const std::vector<int> &faceSources = Geom.GetFaceSources();
+    if (!faceSources.empty())
+    {
+        if (Geom.GetSourceRanges().empty())
+        {
+            _faceSources += TfStringPrintf("%s %s 0: %s\n", label.c_str(), label.c_str(),
+                                           _FormatIndexRuns(faceSources.data(), faceSources.size()).c_str());
+        }
+        for (const GeoData::SourceRange &range : Geom.GetSourceRanges())
+        {
+            _faceSources += TfStringPrintf("%s %s %zu: %s\n", label.c_str(), range.label.c_str(), range.firstFace,
+                                           _FormatIndexRuns(faceSources.data() + range.firstFace, range.numFaces).c_str());
+        }
+    }
+
+    // The UDIM tiles its uvs occupy, for channels to be made on those only
+    if (Geom.HasUVs())
+    {
+        _udimTiles += TfStringPrintf("%s %s\n", label.c_str(), _FormatUdimTiles(Geom.GetUdimTiles()).c_str());
+        _entityUdimTiles |= Geom.GetUdimTiles();
+        if (Geom.GetNumFacesOutsideUdims() > 0)
+        {
+            MARI_USD_LOG_WARNING(_log, "** %zu faces of %s have uvs outside of the UDIM tiles", Geom.GetNumFacesOutsideUdims(), label.c_str());
+            _log.Count("mesh objects with uvs outside of the UDIM tiles", "faces centred outside of 0-10 in u, 0-100 in v");
+            _stats.facesOutsideUdims += Geom.GetNumFacesOutsideUdims();
+        }
     }
 
     return MRI_GPR_SUCCEEDED;
 }
 
+MriGeoPluginResult UsdReader::_MakeGeoEntities(GeoData &Geom,
+                                               MriGeoEntityHandle &Entity,
+                                               const string &label,
+                                               const vector<int> &frames,
+                                               bool createFaceSelectionGroups,
+                                               size_t &meshObjects)
+{
+    std::vector<std::shared_ptr<GeoData> > parts = Geom.Split(_options.maxFacesPerObject, kMaxFaceVerticesPerObject, label);
+
+    meshObjects = 0;
+    MriGeoPluginResult result = MRI_GPR_SUCCEEDED;
+    if (parts.empty())
+    {
+        result = _MakeGeoEntity(Geom, Entity, label, frames, createFaceSelectionGroups);
+        meshObjects = 1;
+    }
+    for (size_t i = 0; i < parts.size() && result == MRI_GPR_SUCCEEDED; ++i)
+    {
+        result = _MakeGeoEntity(*parts[i], Entity, TfStringPrintf("%s_part%zu", label.c_str(), i), frames, createFaceSelectionGroups);
+        parts[i].reset();
+        ++meshObjects;
+    }
+    _selectionGroups.clear();
+
+    if (!parts.empty())
+    {
+        MARI_USD_LOG_INFO(_log, "Split %s (%zu faces) into %zu mesh objects", label.c_str(),
+                          Geom.GetNumFaceVertexCounts(), parts.size());
+        _log.Count("meshes split", "over the face budget or host buffer size");
+    }
+    return result;
+}
+
 void
 UsdReader::_ParseUVs(MriUserItemHandle SettingsHandle,
                            GeoData::UVSet uvs, 
@@ -815,46 +1991,31 @@ UsdReader::_ParseUVs(MriUserItemHandle SettingsHandle,
 }
 
 void
-UsdReader::_GetMariAttributes(MriGeoEntityHandle &Entity,
-                                    std::string& loadOption,
-                                    std::string& mergeOption,
-                                    std::string& mappingScheme,
-                                    vector<int>& frames,
-                                    std::string& frameString,
-                                    vector<string>& requestedModelNames,
-                                    vector<string>& requestedGprimNames,
-                                    std::string& UVSet,
-                                    vector<SdfPath>& variantSelections,
-                                    bool& conformToMariY,
-                                    bool& keepCentered,
-                                    bool& includeInvisible,
-                                    bool& createFaceSelectionGroups)
+UsdReader::_GetMariAttributes(MriGeoEntityHandle &Entity, LoadOptions &options)
 {
     MriAttributeValue Value;
 
     // detect requested load option
     if (_host.getAttribute(Entity, "Load", &Value) == MRI_UPR_SUCCEEDED)
-        loadOption = Value.m_pString;
+        options.loadOption = Value.m_pString;
 
-    _host.trace("%s:%d] requested Load Option %s", _pluginName, __LINE__,
-                loadOption.c_str());
+    MARI_USD_LOG_INFO(_log, "requested Load Option %s", options.loadOption.c_str());
 
-    if (loadOption == "First Found\nAll Models\nSpecified Models in Model Names")
+    if (options.loadOption == "First Found\nAll Models\nSpecified Models in Model Names")
     {
         // Default when unset
-        loadOption = "All Models";
+        options.loadOption = "All Models";
     }
 
     // detect requested merge option
     if (_host.getAttribute(Entity, "Merge Type", &Value) == MRI_UPR_SUCCEEDED)
-        mergeOption = Value.m_pString;
-    _host.trace("%s:%d] requested Merge Option %s", _pluginName, __LINE__,
-                mergeOption.c_str());
+        options.mergeOption = Value.m_pString;
+    MARI_USD_LOG_INFO(_log, "requested Merge Option %s", options.mergeOption.c_str());
 
-    if (mergeOption == "Merge Models\nKeep Models Separate")
+    if (options.mergeOption == kMergeOptions)
     {
         // Default when unset
-        mergeOption = "Merge Models";
+        options.mergeOption = "Merge Models";
     }
 
     // detect requested model name
@@ -862,126 +2023,334 @@ UsdReader::_GetMariAttributes(MriGeoEntityHandle &Entity,
     if (_host.getAttribute(Entity, "Model Names", &Value) == MRI_UPR_SUCCEEDED)
         modelNamesString = Value.m_pString;
 
-    requestedModelNames = TfStringTokenize(modelNamesString, ",");
+    options.requestedModelNames = TfStringTokenize(modelNamesString, ",");
 
-    _host.trace("%s:%d] requested modelNames %s", _pluginName, __LINE__,
-                modelNamesString.c_str());
+    MARI_USD_LOG_INFO(_log, "requested modelNames %s", modelNamesString.c_str());
 
     // detect requested UV set
     if (_host.getAttribute(Entity, "UV Set", &Value) == MRI_UPR_SUCCEEDED)
     {
         if (Value.m_pString == kNoUvSetFoundStr)
         {
-            UVSet = "";
-            _host.trace("%s:%d] No uv set found", _pluginName, __LINE__);
+            options.UVSet = "";
+            MARI_USD_LOG_INFO(_log, "No uv set found");
         }
         else
         {
-            UVSet = Value.m_pString;
-            UVSet = UVSet.substr(0, UVSet.find(" "));
+            options.UVSet = Value.m_pString;
+            options.UVSet = options.UVSet.substr(0, options.UVSet.find(" "));
 
-            _host.trace("%s:%d] Using uv set %s", _pluginName, __LINE__, UVSet.c_str());
+            MARI_USD_LOG_INFO(_log, "Using uv set %s", options.UVSet.c_str());
         }
     }
 
+    // Uv sets to import on top of the main one, as mesh objects of their own
+    if (_host.getAttribute(Entity, "Additional UV Sets", &Value) == MRI_UPR_SUCCEEDED && Value.m_pString)
+    {
+        options.additionalUvSets = TfStringTokenize(Value.m_pString, ", ");
+        if (!options.additionalUvSets.empty())
+            MARI_USD_LOG_INFO(_log, "Also importing uv sets %s", Value.m_pString);
+    }
+
     // Mapping scheme option
     if (_host.getAttribute(Entity, "Mapping Scheme", &Value) == MRI_UPR_SUCCEEDED)
-        mappingScheme = Value.m_pString;
+        options.mappingScheme = Value.m_pString;
 
-    _host.trace("%s:%d] Mappping scheme Option %s", _pluginName, __LINE__,
-                mappingScheme.c_str());
+    MARI_USD_LOG_INFO(_log, "Mappping scheme Option %s", options.mappingScheme.c_str());
 
-    if (mappingScheme == kMappingSchemeOptions)
+    if (options.mappingScheme == kMappingSchemeOptions)
     {
         // Default when unset
-        mappingScheme = "UV if available, Ptex otherwise";
+        options.mappingScheme = "UV if available, Ptex otherwise";
     }
 
     // detect requested frames
     if (_host.getAttribute(Entity, "Frame Numbers", &Value) ==
             MRI_UPR_SUCCEEDED)
-        frameString = Value.m_pString;
+        options.frameString = Value.m_pString;
 
-    _GetFrameList(frameString, frames);
-    _host.trace("%s:%d] requested %lu frames", _pluginName, __LINE__,
-                frames.size());
+    _GetFrameList(options.frameString, options.frames);
+    MARI_USD_LOG_INFO(_log, "requested %lu frames", options.frames.size());
 
     // detect requested gprim names
     std::string gprimNamesString;
     if (_host.getAttribute(Entity, "Gprim Names", &Value) == MRI_UPR_SUCCEEDED)
         gprimNamesString = Value.m_pString;
-    requestedGprimNames = TfStringTokenize(gprimNamesString, ",");
+    options.requestedGprimNames = TfStringTokenize(gprimNamesString, ",");
 
-    _host.trace("%s:%d] requested gprimString %s", _pluginName, __LINE__, 
-                gprimNamesString.c_str());
+    MARI_USD_LOG_INFO(_log, "requested gprimString %s", gprimNamesString.c_str());
 
     std::string variantsString;
     if (_host.getAttribute(Entity, "Variants", &Value) == MRI_UPR_SUCCEEDED)
     {
         variantsString = Value.m_pString;
-        _GetVariantSelectionsList(variantsString, variantSelections);
-        _host.trace("%s:%d] Using variants %s", _pluginName, __LINE__, variantsString.c_str());
+        _GetVariantSelectionsList(variantsString, options.variantSelections);
+        MARI_USD_LOG_INFO(_log, "Using variants %s", variantsString.c_str());
     }
 
     // conform to Mari Y is up
     if( _host.getAttribute(Entity, "Conform to Mari Y as up", &Value) ==
         MRI_UPR_SUCCEEDED )
-        conformToMariY = (Value.m_Int !=0);
-    _host.trace("%s:%d] Conform to Mari Y is up : %d", _pluginName, __LINE__, conformToMariY);
+        options.conformToMariY = (Value.m_Int !=0);
+    MARI_USD_LOG_INFO(_log, "Conform to Mari Y is up : %d", options.conformToMariY);
 
     // detect if we want to ignore model transforms
     if( _host.getAttribute(Entity, "Keep Centered", &Value) ==
         MRI_UPR_SUCCEEDED )
-        keepCentered = (Value.m_Int !=0);
-    if( keepCentered )
-        _host.trace("%s:%d] Discarding model transforms.", _pluginName, __LINE__);
+        options.keepCentered = (Value.m_Int !=0);
+    if( options.keepCentered )
+        MARI_USD_LOG_INFO(_log, "Discarding model transforms.");
 
     // detect if we want to include invisible gprims
     if( _host.getAttribute(Entity, "Include Invisible", &Value) ==
         MRI_UPR_SUCCEEDED )
-        includeInvisible = (Value.m_Int !=0);
-    if( !includeInvisible )
-        _host.trace("%s:%d] Discarding invisible gprims.", _pluginName, __LINE__);
+        options.includeInvisible = (Value.m_Int !=0);
+    if( !options.includeInvisible )
+        MARI_USD_LOG_INFO(_log, "Discarding invisible gprims.");
 
     // detect if we want to create face selection groups
     if( _host.getAttribute(Entity, "Create Face Selection Group per mesh", &Value) ==
         MRI_UPR_SUCCEEDED )
-        createFaceSelectionGroups = (Value.m_Int !=0);
+        options.createFaceSelectionGroups = (Value.m_Int !=0);
+
+    if( options.createFaceSelectionGroups )
+        MARI_USD_LOG_INFO(_log, "Will create face selection groups.");
+
+    if( _host.getAttribute(Entity, "Generate Missing Normals", &Value) ==
+        MRI_UPR_SUCCEEDED )
+        options.generateNormals = (Value.m_Int !=0);
+    if( options.generateNormals )
+        MARI_USD_LOG_INFO(_log, "Will generate smooth normals for meshes without any.");
+
+    if( _host.getAttribute(Entity, "Clean Up Meshes", &Value) ==
+        MRI_UPR_SUCCEEDED )
+        options.cleanUp = (Value.m_Int !=0);
+    if( options.cleanUp )
+        MARI_USD_LOG_INFO(_log, "Will remove unused points and degenerate faces.");
+
+    if( _host.getAttribute(Entity, "Optimise for Painting", &Value) ==
+        MRI_UPR_SUCCEEDED )
+        options.reorderForPainting = (Value.m_Int !=0);
+    if( options.reorderForPainting )
+        MARI_USD_LOG_INFO(_log, "Will reorder faces and points for painting.");
+
+    if( _host.getAttribute(Entity, "Max Faces per Mesh Object", &Value) ==
+        MRI_UPR_SUCCEEDED )
+        options.maxFacesPerObject = size_t(std::max(Value.m_Int, 0));
+    if( options.maxFacesPerObject > 0 )
+        MARI_USD_LOG_INFO(_log, "Will split meshes over %zu faces into several mesh objects.", options.maxFacesPerObject);
 
-    if( createFaceSelectionGroups )
-        _host.trace("%s:%d] Will create face selection groups.", _pluginName, __LINE__);
+    // detect re-import, with the hashes saved on the entity by the previous import
+    if( _host.getAttribute(Entity, "Patch With Changed Meshes Only", &Value) ==
+        MRI_UPR_SUCCEEDED )
+        options.changedMeshesOnly = (Value.m_Int !=0);
+    if( options.changedMeshesOnly )
+    {
+        if (_host.getAttribute(Entity, "UsdImportMeshHashes", &Value) == MRI_UPR_SUCCEEDED && Value.m_pString)
+            options.previousMeshHashes = Value.m_pString;
+        MARI_USD_LOG_INFO(_log, "Will make a patch of the meshes changed since the previous import.");
+    }
 }
 
 void
 UsdReader::_SaveMetadata(
         MriGeoEntityHandle &Entity,
         const ModelData& modelData)
+{
+    _SaveMetadata(Entity, modelData.GetMetadata());
+}
+
+void
+UsdReader::_SaveMetadata(
+        MriGeoEntityHandle &Entity,
+        const map<string, string> &metadata)
 {
     MriAttributeValue Value;
     Value.m_Type = MRI_ATTR_STRING;
-    map<string, string> metadata = modelData.GetMetadata();
-    map<string, string>::iterator it;
-    _host.trace("%s:%d] Using metadata setAttribute (>2.0)", _pluginName, __LINE__);
+    map<string, string>::const_iterator it;
+    MARI_USD_LOG_DEBUG(_log, "Using metadata setAttribute (>2.0)");
     for (it = metadata.begin(); it!=metadata.end();++it)
     {
         Value.m_pString = it->second.c_str();
-        _host.trace("%s:%d] setting metadata %s to %s", _pluginName, __LINE__, 
+        MARI_USD_LOG_DEBUG(_log, "setting metadata %s to %s",
             it->first.c_str(), it->second.c_str());
         _host.setAttribute(Entity, it->first.c_str(), &Value);
     }
 }
 
-std::string UsdReader::GetLog()
+void
+UsdReader::_SaveTopologyFingerprints(MriGeoEntityHandle &Entity)
 {
-    // This code block performs typical join() operation
-    std::ostringstream os;
-    std::copy(_log.begin(), _log.end(), std::ostream_iterator<std::string>(os,"\n"));
-    std::string result = os.str();
-    if(result.size()>0)
+    if (_topologyFingerprints.empty())
+        return;
+
+    // One "<fingerprint> <mesh object>" line per mesh object, and a
+    // fingerprint of the whole entity made of theirs, in upload order
+    string lines;
+    vector<uint64_t> fingerprints;
+    for (const auto &it : _topologyFingerprints)
     {
-        result.erase(result.size()-1);
+        lines += TfStringPrintf("%016llx %s\n", (unsigned long long)it.second, it.first.c_str());
+        fingerprints.push_back(it.second);
     }
+    const uint64_t entityFingerprint =
+        GeoDataKernels::Hash64(fingerprints.data(), fingerprints.size() * sizeof(uint64_t), 0);
 
-    return result;
+    map<string, string> metadata;
+    metadata["UsdTopologyFingerprints"] = lines;
+    metadata["UsdTopologyFingerprint"] = TfStringPrintf("%016llx", (unsigned long long)entityFingerprint);
+    _SaveMetadata(Entity, metadata);
+
+    _topologyFingerprints.clear();
+}
+
+void
+UsdReader::_SaveFaceSources(MriGeoEntityHandle &Entity)
+{
+    if (_faceSources.empty())
+        return;
+
+    map<string, string> metadata;
+    metadata["UsdFaceSources"] = _faceSources;
+    _SaveMetadata(Entity, metadata);
+
+    _faceSources.clear();
+}
+
+void
+UsdReader::_SaveUdimTiles(MriGeoEntityHandle &Entity)
+{
+    if (_udimTiles.empty())
+        return;
+
+    map<string, string> metadata;
+    metadata["UsdUdimTiles"] = _udimTiles;
+    metadata["UsdUdims"] = _FormatUdimTiles(_entityUdimTiles);
+    _SaveMetadata(Entity, metadata);
+
+    _stats.udimTiles |= _entityUdimTiles;
+    _udimTiles.clear();
+    _entityUdimTiles.reset();
+}
+
+void
+UsdReader::_SaveImportStats(MriGeoEntityHandle &Entity)
+{
+    MriAttributeValue Value;
+    Value.m_Type = MRI_ATTR_STRING;
+    map<string, string> attributes = _stats.GetAttributes();
+    for (map<string, string>::iterator it = attributes.begin(); it!=attributes.end();++it)
+    {
+        Value.m_pString = it->second.c_str();
+        _host.setAttribute(Entity, it->first.c_str(), &Value);
+    }
+
+    MARI_USD_LOG_INFO(_log, "Imported %zu meshes (%zu rejected), %zu faces, %zu points in %s ms",
+                      _stats.meshesImported, _stats.meshesRejected, _stats.faces, _stats.points,
+                      attributes["UsdImportTotalMs"].c_str());
+    if (_stats.udimTiles.any())
+        MARI_USD_LOG_INFO(_log, "UDIM tiles occupied: %s", _FormatUdimTiles(_stats.udimTiles).c_str());
+    _log.FlushTraces();
+    _log.TraceCounts();
+}
+
+void
+UsdReader::_FinishImport(MriGeoEntityHandle &Entity, MriGeoPluginResult result)
+{
+    _stats.totalTimer.Stop();
+    _SaveImportStats(Entity);
+
+    if (!ImportReport::IsEnabled())
+        return;
+
+    // Serialise the report now that the import is done
+    _report.SetResult(result == MRI_GPR_SUCCEEDED ? "succeeded" : "failed");
+    _report.SetStats(_stats.GetAttributes());
+
+    FILE *logFile = _GetLogFile();
+    if (!logFile)
+    {
+        MARI_USD_LOG_INFO(_log, "Cannot write import report to %s", _logFilePath.c_str());
+        _log.FlushTraces();
+        return;
+    }
+    _report.Write(logFile);
+    fclose(logFile);
+    _logFile = nullptr;
+
+    static std::mutex indexMutex;
+    std::lock_guard<std::mutex> lock(indexMutex);
+    if (FILE *index = _GetMetadataFile())
+    {
+        fprintf(index, "%s\n", _report.GetSummary(_logFilePath).c_str());
+        fflush(index);
+    }
+}
+
+FILE *
+UsdReader::_OpenLogFile()
+{
+    static std::atomic<int> reportCount(0);
+    _logFilePath = TfStringPrintf("%s/%s.%d.%d.report.json",
+                                  ImportReport::GetDirectory().c_str(),
+                                  TfGetBaseName(_fileName).c_str(),
+                                  ArchGetProcessId(),
+                                  reportCount++);
+    return fopen(_logFilePath.c_str(), "w");
+}
+
+FILE *
+UsdReader::_GetLogFile()
+{
+    if (!_logFile)
+        _logFile = _OpenLogFile();
+    return _logFile;
+}
+
+FILE *
+UsdReader::_GetMetadataFile()
+{
+    // Kept open for the lifetime of the process
+    static FILE *index = fopen((ImportReport::GetDirectory() + "/imports.jsonl").c_str(), "a");
+    return index;
+}
+
+MriGeoPluginResult
+UsdReader::_CreateGeoData(MriGeoEntityHandle &Entity,
+                          const void *data,
+                          size_t size,
+                          MriGeoDataType type,
+                          MriGeoDataRole role,
+                          MriGeoDataHandle *dataOut)
+{
+    if (size > size_t(INT_MAX))
+    {
+        MARI_USD_LOG_ERROR(_log, "** Geometry buffer of %zu bytes is over the host's limit", size);
+        return MRI_GPR_FAILED;
+    }
+    _stats.bytesCreateGeoData += size;
+    return _host.createGeoData(Entity, data, size, type, role, dataOut);
+}
+
+MriGeoPluginResult
+UsdReader::_SetGeoDataForFrame(MriGeoEntityHandle &Entity,
+                               MriGeoDataHandle data,
+                               int frame,
+                               const void *buffer,
+                               size_t size)
+{
+    if (size > size_t(INT_MAX))
+    {
+        MARI_USD_LOG_ERROR(_log, "** Geometry buffer of %zu bytes is over the host's limit", size);
+        return MRI_GPR_FAILED;
+    }
+    _stats.bytesSetGeoDataForFrame += size;
+    return _host.setGeoDataForFrame(Entity, data, frame, buffer, size);
+}
+
+std::string UsdReader::GetLog()
+{
+    // Messages, then the aggregated counts
+    return _log.GetText();
 }
 
@@ -33,11 +33,18 @@
 
 #include "MriGeoReaderPlugin.h"
 #include "GeoData.h"
+#include "MeshHash.h"
 #include "ModelData.h"
+#include "ImportLog.h"
+#include "ImportReport.h"
+#include "ImportStats.h"
 #include "pxr/usd/usd/stage.h"
 #include "pxr/usd/usd/prim.h"
 #include "pxr/usd/usd/variantSets.h"
 
+#include <memory>
+#include <vector>
+
 /// This macro provides a very simple result code check
 #define CHECK_RESULT(expr)  { \
                                 Result = expr; \
@@ -45,13 +52,58 @@
                                     return Result; \
                             }
 
+/// Same as CHECK_RESULT, counting the call in the reader's ImportStats
+#define CHECK_HOST_CALL(expr)   { \
+                                    ++_stats.hostCalls; \
+                                    CHECK_RESULT(expr) \
+                                }
+
 
 /// UsdReader base class.
 class UsdReader
 {
+    friend class UsdBatchReader;
+
     public:
 
+        // Import options, as set on the geo entity by the import dialog
+        struct LoadOptions
+        {
+            std::string loadOption;
+            std::string mergeOption;
+            std::string mappingScheme;
+            std::vector<int> frames;
+            std::string frameString;
+            std::vector<std::string> requestedModelNames;
+            std::vector<std::string> requestedGprimNames;
+            std::string UVSet;
+            // Uv sets imported on top of UVSet, "*" for all of them
+            std::vector<std::string> additionalUvSets;
+            std::vector<PXR_NS::SdfPath> variantSelections;
+            bool conformToMariY = true;
+            bool keepCentered = false;
+            bool includeInvisible = false;
+            bool createFaceSelectionGroups = false;
+            // Area weighted smooth normals for meshes without any, split
+            // along creases
+            bool generateNormals = false;
+            // Drop the points no face uses and the faces with no area
+            bool cleanUp = false;
+            // Reorder faces and points for locality ("Optimise for Painting")
+            bool reorderForPainting = false;
+            // Meshes with more faces are split into several mesh objects,
+            // 0 for no limit ("Max Faces per Mesh Object")
+            size_t maxFacesPerObject = 0;
+            // Re-import as a patch: only upload the meshes that changed
+            // since the import that saved previousMeshHashes on the entity,
+            // which the patch is loaded alongside ("Patch With Changed
+            // Meshes Only")
+            bool changedMeshesOnly = false;
+            std::string previousMeshHashes;
+        };
+
         UsdReader(const char* pFileName, MriGeoReaderHost &pHost);
+        ~UsdReader();
 
         std::string GetLog();
 
@@ -60,6 +112,10 @@ class UsdReader
         MriGeoPluginResult GetSettings(MriUserItemHandle SettingsHandle);
 
         static const std::string kMappingSchemeOptions;
+        static const std::string kMergeOptions;
+        static const std::string kConsolidateMeshes;
+        static const size_t kMaxConsolidatedFaces;
+        static const size_t kMaxFaceVerticesPerObject;
 
     protected:
         MriGeoPluginResult _MakeGeoEntity(GeoData &Geom, 
@@ -67,6 +123,15 @@ class UsdReader
                 std::string label, 
                 const std::vector<int> &frames,
                 bool createFaceSelectionGroups);
+
+        // _MakeGeoEntity, for each part of the mesh when it is over the
+        // face budget or the host's buffer size, counting the mesh objects
+        MriGeoPluginResult _MakeGeoEntities(GeoData &Geom,
+                MriGeoEntityHandle &Entity,
+                const std::string &label,
+                const std::vector<int> &frames,
+                bool createFaceSelectionGroups,
+                size_t &meshObjects);
         
         static void _GetFrameList(const std::string &frameString, 
                 std::vector<int> &frames);
@@ -74,36 +139,159 @@ class UsdReader
         static void _GetVariantSelectionsList(const std::string &variantsString, 
                 std::vector<PXR_NS::SdfPath> &variants);
 
+        // Index of all the imports made by this process, appended to
         static FILE * _GetMetadataFile();
-        static FILE * _GetLogFile();
+        // JSON report of this import, opened on first use
+        FILE * _GetLogFile();
         void _ParseUVs(MriUserItemHandle SettingsHandle, 
                 GeoData::UVSet uvs, int size);
         
-        void _GetMariAttributes(MriGeoEntityHandle &Entity,
-                std::string& loadOption,
-                std::string& mergeOption,
-                std::string &mappingScheme,
-                std::vector<int>& frames,
-                std::string& frameString,
-                std::vector<std::string>& requestedModelNames,
-                std::vector<std::string>& requestedGprimNames,
-                std::string& UVSet,
-                std::vector<PXR_NS::SdfPath>& variantSelections,
-                bool &conformToMariY,
-                bool& keepCentered,
-                bool& includeInvisible,
-                bool& createFaceSelectionGroups);
+        void _GetMariAttributes(MriGeoEntityHandle &Entity, LoadOptions &options);
+
+        // The uv sets of the meshes, and the number of prims, for the "UV Set"
+        // setting. Makes no host calls, its messages are held by _log.
+        MriGeoPluginResult _CollectUvSets(GeoData::UVSet &uvs, int &size);
+
+        // Load is split in two: _Read opens the stage and finds the meshes
+        // to import, and extracts them all when asked to; it makes no host
+        // calls, its messages are held by _log, so several readers can _Read
+        // at once on worker threads. _Upload then traces them and hands the
+        // meshes to the host, extracting the ones _Read did not.
+        MriGeoPluginResult _Read(const LoadOptions &options, bool extract);
+        void _Extract();
+
+        // Picks the first of each set of identical meshes found by _Read as
+        // the original the others share their channels with. The topology
+        // of every mesh is hashed in parallel, and the content only of those
+        // whose topology matches another's.
+        void _HashMeshes();
+
+        // Hashes the GeoData of every mesh into _meshHashes for a patch,
+        // dropping each of them once hashed, so that only the changed ones
+        // are extracted to be uploaded
+        void _HashForPatch();
+
+        // Compares _meshHashes with the ones saved by the previous import,
+        // marks the unchanged meshes and leaves them out of deduplication
+        void _DiffAgainstPreviousImport();
+
+        // Hash of the options that change the GeoData of every mesh
+        std::string _GetOptionsHash() const;
+
+        // Saves _meshHashes on the entity, for the next re-import. They are
+        // hashed from the extracted GeoData, as they are uploaded.
+        void _SaveMeshHashes(MriGeoEntityHandle &Entity);
+
+        // The additional uv sets to read from a mesh
+        std::vector<std::string> _GetAdditionalUvSets(PXR_NS::UsdPrim const &prim) const;
+
+        // GeoData of one mesh of _gprims, logging to log. The originals with
+        // duplicates left to extract are kept until the last of them is.
+        std::shared_ptr<GeoData> _ExtractMesh(size_t meshIndex, ImportLog &log);
+        MriGeoPluginResult _Upload(MriGeoEntityHandle &Entity);
+
+        // A mesh held back by the "Consolidate Meshes" merge option until
+        // the rest of its model has been read
+        struct PendingMesh
+        {
+            std::shared_ptr<GeoData> geom;
+            std::string handle;
+            ImportReport::Mesh reportMesh;
+        };
+
+        // Concatenates the compatible meshes of a model into as few mesh
+        // objects as possible and uploads them
+        void _UploadConsolidated(std::vector<PendingMesh> &meshes,
+                MriGeoEntityHandle &Entity,
+                const std::string &modelName);
 
         void _SaveMetadata(
                 MriGeoEntityHandle &Entity,
                 const ModelData& modelData);
+        void _SaveMetadata(
+                MriGeoEntityHandle &Entity,
+                const std::map<std::string, std::string> &metadata);
+
+        // Saves the topology fingerprints of the mesh objects made for the
+        // entity, for geometry version matching, and clears them
+        void _SaveTopologyFingerprints(MriGeoEntityHandle &Entity);
+
+        // Saves where the faces of the mesh objects made for the entity
+        // were read from, for those cleaned up or reordered, and clears it
+        void _SaveFaceSources(MriGeoEntityHandle &Entity);
+
+        // Saves the UDIM tiles the uvs of the mesh objects made for the
+        // entity occupy, each and all together, and clears them
+        void _SaveUdimTiles(MriGeoEntityHandle &Entity);
+
+        void _SaveImportStats(MriGeoEntityHandle &Entity);
+
+        void _FinishImport(MriGeoEntityHandle &Entity, MriGeoPluginResult result);
+
+        // Host geometry calls that also account the bytes in _stats
+        MriGeoPluginResult _CreateGeoData(MriGeoEntityHandle &Entity,
+                const void *data,
+                size_t size,
+                MriGeoDataType type,
+                MriGeoDataRole role,
+                MriGeoDataHandle *dataOut);
+
+        MriGeoPluginResult _SetGeoDataForFrame(MriGeoEntityHandle &Entity,
+                MriGeoDataHandle data,
+                int frame,
+                const void *buffer,
+                size_t size);
     
     protected:
         const char* _pluginName;
         const char* _fileName;
         MriGeoReaderHost _host;
-        std::vector<std::string> _log;
+        ImportLog _log;
+        // Face selection groups of the mesh being uploaded, shared by its
+        // parts when it is split
         std::map<std::string, MriSelectionGroupHandle> _selectionGroups;
+        ImportStats _stats;
+        ImportReport _report;
+        FILE *_logFile;
+        std::string _logFilePath;
+        const GeoData::PathFilter _pathFilter;
+
+        // State passed from _Read to _Upload
+        LoadOptions _options;
+        MriGeoPluginResult _readResult;
+        PXR_NS::UsdStageRefPtr _stage;
+        std::string _stagePrimPath;
+        std::vector<ModelData*> _modelDataList;
+        std::vector<std::pair<const ModelData*, PXR_NS::UsdPrim> > _gprims;
+        std::vector<std::shared_ptr<GeoData> > _extracted;
+        // Warnings of each mesh _Extract made, for the import report
+        std::vector<std::vector<std::string> > _extractedWarnings;
+
+        // Deduplication: index in _gprims of the original of each mesh (its
+        // own index if it has none), the duplicates each original has left to
+        // extract, and the originals waiting for them
+        std::vector<size_t> _meshOriginals;
+        std::vector<size_t> _duplicatesLeft;
+        std::map<size_t, std::shared_ptr<GeoData> > _originals;
+
+        // MeshHash of the GeoData of each mesh of _gprims, and how it
+        // compares with the previous import (re-import only)
+        enum class MeshChange {NotCompared, Unchanged, Changed, Added};
+        std::vector<MeshHash> _meshHashes;
+        std::vector<MeshChange> _meshChanges;
+
+        // Name and topology fingerprint of each mesh object made for the
+        // entity being populated
+        std::vector<std::pair<std::string, uint64_t> > _topologyFingerprints;
+
+        // "<mesh object> <mesh> <first face>: <faces read>" lines, one per
+        // mesh whose faces were cleaned up or reordered
+        std::string _faceSources;
+
+        // "<mesh object> <UDIM tiles>" lines, one per mesh object with uvs
+        // made for the entity being populated, and all of their tiles
+        std::string _udimTiles;
+        GeoDataKernels::UdimTiles _entityUdimTiles;
 
         bool    m_upAxisIsY;
 
@@ -113,7 +301,10 @@ class UsdReader
         int _startTime;
 
     private:
-        PXR_NS::UsdStageRefPtr _OpenUsdStage();
+        // An editable stage gets a session layer of its own as edit target.
+        // reload reads again the layers changed on disk since they were
+        // opened.
+        PXR_NS::UsdStageRefPtr _OpenUsdStage(bool editable, bool reload);
         FILE *_OpenLogFile();
         
 };
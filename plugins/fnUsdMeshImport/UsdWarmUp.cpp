@@ -0,0 +1,131 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "UsdWarmUp.h"
+
+#include "pxr/base/plug/registry.h"
+#include "pxr/base/tf/envSetting.h"
+#include "pxr/base/tf/stopwatch.h"
+#include "pxr/base/tf/type.h"
+#include "pxr/base/trace/trace.h"
+#include "pxr/base/work/loops.h"
+#include "pxr/base/work/threadLimits.h"
+#include "pxr/usd/sdf/fileFormat.h"
+#include "pxr/usd/usd/schemaRegistry.h"
+#include "pxr/usd/usd/stage.h"
+#include "pxr/usd/usdGeom/mesh.h"
+
+#include <mutex>
+#include <thread>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+TF_DEFINE_ENV_SETTING(MARI_USD_WARM_UP, true,
+        "Initialise USD on a background thread when the importer library is "
+        "preloaded (MARI_USD_PRELOAD=1), instead of during the first import.");
+
+namespace
+{
+    mutex sWarmUpMutex;
+    TfStopwatch sWarmUpTimer;
+
+    // Joined at exit if no import waited for it, as destroying a joinable
+    // std::thread terminates the process. Declared after the timer the
+    // thread uses, so that it is destroyed first.
+    struct WarmUpThread
+    {
+        std::thread handle;
+        ~WarmUpThread()
+        {
+            if (handle.joinable())
+                handle.join();
+        }
+    } sWarmUpThread;
+
+    void _WarmUp()
+    {
+        TRACE_FUNCTION();
+        sWarmUpTimer.Start();
+
+        {
+            TRACE_SCOPE("UsdWarmUp: plug-in registry");
+            PlugRegistry::GetInstance();
+        }
+        {
+            TRACE_SCOPE("UsdWarmUp: schema registry");
+            UsdSchemaRegistry::GetInstance();
+            TfType::Find<UsdGeomMesh>();
+        }
+        {
+            // Finding a format loads the library of its plug-in
+            TRACE_SCOPE("UsdWarmUp: file formats");
+            SdfFileFormat::FindByExtension("usda");
+            SdfFileFormat::FindByExtension("usdc");
+            SdfFileFormat::FindByExtension("usdz");
+        }
+        {
+            // Start the worker threads of the pool the imports run in
+            TRACE_SCOPE("UsdWarmUp: worker threads");
+            WorkParallelForN(WorkGetConcurrencyLimit(), [](size_t, size_t) {});
+        }
+
+        sWarmUpTimer.Stop();
+    }
+}
+
+void
+UsdWarmUp::Start()
+{
+    lock_guard<mutex> lock(sWarmUpMutex);
+    if (sWarmUpThread.handle.joinable() || sWarmUpTimer.GetSampleCount() > 0)
+        return;
+
+    if (!TfGetEnvSetting(MARI_USD_WARM_UP))
+        return;
+
+    sWarmUpThread.handle = thread(&_WarmUp);
+}
+
+void
+UsdWarmUp::Wait(const MriGeoReaderHost &host)
+{
+    lock_guard<mutex> lock(sWarmUpMutex);
+    if (!sWarmUpThread.handle.joinable())
+        return;
+
+    TfStopwatch waitTimer;
+    waitTimer.Start();
+    sWarmUpThread.handle.join();
+    waitTimer.Stop();
+
+    host.trace("[UsdPlugin] USD warm-up took %.1f ms, waited %.1f ms for it",
+               sWarmUpTimer.GetMilliseconds(), waitTimer.GetMilliseconds());
+}
@@ -0,0 +1,55 @@
+#ifndef USD_WARM_UP_H
+#define USD_WARM_UP_H
+
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "MriGeoReaderPlugin.h"
+
+#include "MariHostConfig.h"
+
+class UsdWarmUp
+{
+    // Initialises the parts of USD that every import needs on a background
+    // thread, so that the first import of the session does not pay for them:
+    // plug-in discovery, the schema registry, the usda/usdc/usdz file
+    // formats and the worker threads. Set MARI_USD_WARM_UP=0 to disable it.
+    // Only started when the importer library is preloaded: loaded by the
+    // first import, the library would have that import wait for it anyway.
+public:
+    // Starts the warm-up thread, once
+    static void Start();
+
+    // Waits for the warm-up to finish, if it was started. The first call
+    // traces how long the warm-up took and how long it was waited for.
+    static void Wait(const MriGeoReaderHost &host);
+};
+
+#endif
@@ -0,0 +1,273 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+#include "UsdImportApi.h"
+
+#include "UsdReader.h"
+#include "UsdBatchReader.h"
+#include "UsdWarmUp.h"
+
+#include "pxr/base/tf/stringUtils.h"
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <time.h>
+#include <sstream>
+
+using namespace std;
+PXR_NAMESPACE_USING_DIRECTIVE
+
+// The importer behind the USDImport plug-in shim, see UsdImportApi.h
+
+namespace
+{
+    // The host structure, which contains functions that the importer can call
+    MriGeoReaderHost host;
+
+    // The log of the last load made on each thread. The host reads it through
+    // ppMessagesOut after load returns, so it has to outlive the call; keeping
+    // one per thread lets several threads load at once.
+    thread_local std::string sUsdLog;
+}
+
+//------------------------------------------------------------------------------
+
+USD_IMPORT_IMPL_API void usdImportSetHost(const MriGeoReaderHost *pHost, bool warmUp)
+{
+    host = *pHost;
+
+    // Get USD ready while the user is busy elsewhere. Loaded by the first
+    // import, the library would only start the warm-up to wait for it.
+    if (warmUp)
+        UsdWarmUp::Start();
+}
+
+//------------------------------------------------------------------------------
+
+USD_IMPORT_IMPL_API MriGeoPluginResult usdImportLoad(MriGeoEntityHandle Entity, 
+        const char *pFileName, 
+        const char **ppMessagesOut)
+{
+    
+    boost::shared_ptr<UsdReader> reader;
+
+    // Check the extension
+    if((!TfStringEndsWith(pFileName, ".usd")) &&
+       (!TfStringEndsWith(pFileName, ".usda")) &&
+       (!TfStringEndsWith(pFileName, ".usdc")) &&
+       (!TfStringEndsWith(pFileName, ".usdz")) &&
+       (!UsdBatchReader::IsBatchFile(pFileName))) {
+        host.trace("[UsdPlugin] Unrecognized extension. Failed to getSettings for %s\n", pFileName);
+        return MRI_GPR_FAILED;
+    }
+    // else
+    
+    host.trace("[UsdPlugin] Load %s\n", pFileName);
+    UsdWarmUp::Wait(host);
+    MriGeoPluginResult res;
+    if (UsdBatchReader::IsBatchFile(pFileName))
+    {
+        UsdBatchReader batchReader(pFileName, host);
+        res = batchReader.Load(Entity);
+        sUsdLog = batchReader.GetLog();
+    }
+    else
+    {
+        reader = boost::shared_ptr<UsdReader>(new UsdReader(pFileName, 
+                                                            host));
+        res = reader->Load(Entity);
+        sUsdLog = reader->GetLog();
+    }
+    *ppMessagesOut = sUsdLog.c_str();
+    return res;
+    
+
+}
+
+
+//------------------------------------------------------------------------------
+// Pre-open a USD stage to detect the UV sets and provide parameter options
+
+USD_IMPORT_IMPL_API MriGeoPluginResult usdImportGetSettings(MriUserItemHandle SettingsHandle, 
+        const char *pFileName)
+{
+    
+    host.trace("[UsdPlugin] getSettings %s\n", pFileName);
+
+    boost::shared_ptr<UsdReader> reader;
+
+    // Check the extension
+    if((!TfStringEndsWith(pFileName, ".usd")) &&
+       (!TfStringEndsWith(pFileName, ".usda")) &&
+       (!TfStringEndsWith(pFileName, ".usdc")) &&
+       (!TfStringEndsWith(pFileName, ".usdz")) &&
+       (!UsdBatchReader::IsBatchFile(pFileName))) {
+        host.trace("[UsdPlugin] Unrecognized extension. Failed to getSettings for %s\n", pFileName);
+        return MRI_GPR_FAILED;
+    }
+    // else
+
+    UsdWarmUp::Wait(host);
+
+    // Load option
+    MriAttributeValue LoadValue;
+    LoadValue.m_Type = MRI_ATTR_STRING_LIST;
+    LoadValue.m_pString = "First Found\nAll Models\nSpecified Models in Model Names";
+    host.setAttribute(SettingsHandle,
+        "Load",
+        &LoadValue);
+
+    // Merge option
+    MriAttributeValue MergeValue;
+    MergeValue.m_Type = MRI_ATTR_STRING_LIST;
+    MergeValue.m_pString = UsdReader::kMergeOptions.c_str();
+    host.setAttribute(SettingsHandle,
+        "Merge Type",
+        &MergeValue);
+
+    // Model option
+    MriAttributeValue ModelValue;
+    ModelValue.m_Type = MRI_ATTR_STRING;
+    ModelValue.m_pString = "";
+    host.setAttribute(SettingsHandle,
+        "Model Names",
+        &ModelValue);
+
+    MriGeoPluginResult res;
+    if (UsdBatchReader::IsBatchFile(pFileName))
+    {
+        UsdBatchReader batchReader(pFileName, host);
+        res = batchReader.GetSettings(SettingsHandle);
+    }
+    else
+    {
+        reader = boost::shared_ptr<UsdReader>(new UsdReader(pFileName, 
+                                                            host));
+        res = reader->GetSettings(SettingsHandle);
+    }
+
+    // Additional uv sets
+    MriAttributeValue AdditionalUvSetsValue;
+    AdditionalUvSetsValue.m_Type = MRI_ATTR_STRING;
+    AdditionalUvSetsValue.m_pString = "";
+    host.setAttribute(SettingsHandle, "Additional UV Sets", &AdditionalUvSetsValue);
+
+    // Mapping scheme
+    MriAttributeValue MappingSchemeValue;
+    MappingSchemeValue.m_Type = MRI_ATTR_STRING_LIST;
+    MappingSchemeValue.m_pString = UsdReader::kMappingSchemeOptions.c_str();
+    host.setAttribute(SettingsHandle, "Mapping Scheme", &MappingSchemeValue);
+
+    // frame number
+    MriAttributeValue FrameNumberValue;
+    FrameNumberValue.m_Type = MRI_ATTR_STRING;
+    FrameNumberValue.m_pString = "1";
+    host.setAttribute(SettingsHandle, "Frame Numbers", &FrameNumberValue);
+    
+    // Gprim Names
+    MriAttributeValue GprimValue;
+    GprimValue.m_Type = MRI_ATTR_STRING;
+    GprimValue.m_pString = "";
+    host.setAttribute(SettingsHandle,
+        "Gprim Names",
+        &GprimValue);
+
+    // Variants
+    MriAttributeValue variantsValue;
+    variantsValue.m_Type = MRI_ATTR_STRING;
+    variantsValue.m_pString = "";
+    host.setAttribute(SettingsHandle,
+        "Variants",
+        &variantsValue);
+
+    // Keep centered
+    MriAttributeValue KeepCenteredValue;
+    KeepCenteredValue.m_Type = MRI_ATTR_BOOL;
+    KeepCenteredValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Keep Centered", &KeepCenteredValue);
+
+    // Mari y up
+    MriAttributeValue ConformToMariY;
+    ConformToMariY.m_Type = MRI_ATTR_BOOL;
+    ConformToMariY.m_Int = 1;
+    host.setAttribute(SettingsHandle, "Conform to Mari Y as up", &ConformToMariY);
+
+    // Include Invisible
+    MriAttributeValue IncludeInvisibleValue;
+    IncludeInvisibleValue.m_Type = MRI_ATTR_BOOL;
+    IncludeInvisibleValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Include Invisible", &IncludeInvisibleValue);
+
+    // Include CreateFaceSelectionGroups
+    MriAttributeValue CreateFaceSelectionGroupsValue;
+    CreateFaceSelectionGroupsValue.m_Type = MRI_ATTR_BOOL;
+    CreateFaceSelectionGroupsValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Create Face Selection Group per mesh", &CreateFaceSelectionGroupsValue);
+
+    // Smooth normals for the meshes without any
+    MriAttributeValue GenerateMissingNormalsValue;
+    GenerateMissingNormalsValue.m_Type = MRI_ATTR_BOOL;
+    GenerateMissingNormalsValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Generate Missing Normals", &GenerateMissingNormalsValue);
+
+    // Unused points and degenerate faces
+    MriAttributeValue CleanUpMeshesValue;
+    CleanUpMeshesValue.m_Type = MRI_ATTR_BOOL;
+    CleanUpMeshesValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Clean Up Meshes", &CleanUpMeshesValue);
+
+    // Face and point order
+    MriAttributeValue OptimiseForPaintingValue;
+    OptimiseForPaintingValue.m_Type = MRI_ATTR_BOOL;
+    OptimiseForPaintingValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Optimise for Painting", &OptimiseForPaintingValue);
+
+    // Face budget per mesh object
+    MriAttributeValue MaxFacesPerObjectValue;
+    MaxFacesPerObjectValue.m_Type = MRI_ATTR_INT;
+    MaxFacesPerObjectValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Max Faces per Mesh Object", &MaxFacesPerObjectValue);
+
+    // Re-import as a patch: the entity only receives the meshes changed
+    // since the previous import, and is loaded alongside it
+    MriAttributeValue ChangedMeshesOnlyValue;
+    ChangedMeshesOnlyValue.m_Type = MRI_ATTR_BOOL;
+    ChangedMeshesOnlyValue.m_Int = 0;
+    host.setAttribute(SettingsHandle, "Patch With Changed Meshes Only", &ChangedMeshesOnlyValue);
+
+    return res;
+}
+
+//------------------------------------------------------------------------------
+
+USD_IMPORT_IMPL_API void usdImportFlush()
+{
+    // Do not leave the warm-up thread running into an unloaded library
+    UsdWarmUp::Wait(host);
+}
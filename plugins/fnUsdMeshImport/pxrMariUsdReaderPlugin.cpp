@@ -30,49 +30,173 @@
 
 #include "pxrMariUsdReaderPlugin.h"
 
-#include "UsdReader.h"
+#include "UsdImportApi.h"
 
-#include "pxr/base/tf/stringUtils.h"
-#include <boost/shared_ptr.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
 #include <string>
-#include <time.h>
-#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
 
 using namespace std;
-PXR_NAMESPACE_USING_DIRECTIVE
+
+// This library is only a shim, so that loading it at Mari startup does not
+// load USD: the importer lives in USDImportImpl (see UsdImportApi.h), which
+// is loaded the first time a USD file is imported, or when the plug-in is
+// loaded if MARI_USD_PRELOAD is set to 1.
 
 //-----------------------------------------------------------------------------
-// Plug-in function suite definitions
+// Importer library
 //-----------------------------------------------------------------------------
 
-std::string sUsdLog;
+namespace
+{
+    struct ImplSuite
+    {
+        UsdImportSetHostFn setHost;
+        UsdImportLoadFn load;
+        UsdImportGetSettingsFn getSettings;
+        UsdImportFlushFn flush;
+    };
+
+    mutex sImplMutex;
+    ImplSuite sImpl;
+    bool sImplLoaded = false;
+    bool sImplFailed = false;
+
+#if defined(_WIN32)
+    const char *kImplFileName = USD_IMPORT_IMPL_LIBRARY_NAME ".dll";
+    const char kPathSeparator = '\\';
+#elif defined(__APPLE__)
+    const char *kImplFileName = "lib" USD_IMPORT_IMPL_LIBRARY_NAME ".dylib";
+    const char kPathSeparator = '/';
+#else
+    const char *kImplFileName = "lib" USD_IMPORT_IMPL_LIBRARY_NAME ".so";
+    const char kPathSeparator = '/';
+#endif
+
+    // Directory this library was loaded from, with a trailing separator
+    string _GetPluginDirectory()
+    {
+        string path;
+#if defined(_WIN32)
+        HMODULE module = NULL;
+        char buffer[MAX_PATH];
+        if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                               GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                               (LPCSTR)&getPlugins, &module) &&
+            GetModuleFileNameA(module, buffer, MAX_PATH) > 0)
+        {
+            path = buffer;
+        }
+#else
+        Dl_info info;
+        if (dladdr((void *)&getPlugins, &info) && info.dli_fname)
+        {
+            path = info.dli_fname;
+        }
+#endif
+        return path.substr(0, path.find_last_of("/\\") + 1);
+    }
+
+    void *_OpenLibrary(const string &path)
+    {
+#if defined(_WIN32)
+        return (void *)LoadLibraryA(path.c_str());
+#else
+        return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+    }
+
+    void *_FindSymbol(void *library, const char *name)
+    {
+#if defined(_WIN32)
+        return (void *)GetProcAddress((HMODULE)library, name);
+#else
+        return dlsym(library, name);
+#endif
+    }
+
+    // Loads the importer library on first use, or ahead of it if preload.
+    // Returns null if it cannot be loaded; it is not tried again.
+    const ImplSuite *_GetImpl(bool preload = false)
+    {
+        lock_guard<mutex> lock(sImplMutex);
+        if (sImplLoaded)
+            return &sImpl;
+        if (sImplFailed)
+            return nullptr;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        // Next to the plug-in, in its lib folder, then on the library path
+        const string pluginDirectory = _GetPluginDirectory();
+        vector<string> candidates;
+        if (!pluginDirectory.empty())
+        {
+            candidates.push_back(pluginDirectory + kImplFileName);
+            candidates.push_back(pluginDirectory + "lib" + kPathSeparator + kImplFileName);
+        }
+        candidates.push_back(kImplFileName);
+
+        void *library = nullptr;
+        for (const string &candidate : candidates)
+        {
+            library = _OpenLibrary(candidate);
+            if (library)
+                break;
+        }
+
+        if (library)
+        {
+            sImpl.setHost = (UsdImportSetHostFn)_FindSymbol(library, USD_IMPORT_SET_HOST_SYMBOL);
+            sImpl.load = (UsdImportLoadFn)_FindSymbol(library, USD_IMPORT_LOAD_SYMBOL);
+            sImpl.getSettings = (UsdImportGetSettingsFn)_FindSymbol(library, USD_IMPORT_GET_SETTINGS_SYMBOL);
+            sImpl.flush = (UsdImportFlushFn)_FindSymbol(library, USD_IMPORT_FLUSH_SYMBOL);
+        }
+
+        if (!library || !sImpl.setHost || !sImpl.load || !sImpl.getSettings || !sImpl.flush)
+        {
+#if defined(_WIN32)
+            host.trace("[UsdPlugin] Cannot load %s", kImplFileName);
+#else
+            host.trace("[UsdPlugin] Cannot load %s: %s", kImplFileName, dlerror());
+#endif
+            sImplFailed = true;
+            return nullptr;
+        }
+
+        // The library is never unloaded, USD does not support it
+        sImpl.setHost(&host, preload);
+        sImplLoaded = true;
+
+        host.trace("[UsdPlugin] Loaded %s in %.1f ms", kImplFileName,
+                   chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        return &sImpl;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Plug-in function suite definitions
+//-----------------------------------------------------------------------------
 
 MriGeoPluginResult load(MriGeoEntityHandle Entity, 
         const char *pFileName, 
         const char **ppMessagesOut)
 {
-    
-    boost::shared_ptr<UsdReader> reader;
-
-    // Check the extension
-    if((!TfStringEndsWith(pFileName, ".usd")) &&
-       (!TfStringEndsWith(pFileName, ".usda")) &&
-       (!TfStringEndsWith(pFileName, ".usdc")) &&
-       (!TfStringEndsWith(pFileName, ".usdz"))) {
-        host.trace("[UsdPlugin] Unrecognized extension. Failed to getSettings for %s\n", pFileName);
+    const ImplSuite *impl = _GetImpl();
+    if (!impl)
+    {
+        *ppMessagesOut = "The USD importer library could not be loaded.";
         return MRI_GPR_FAILED;
     }
-    // else
-    
-    host.trace("[UsdPlugin] Load %s\n", pFileName);
-    reader = boost::shared_ptr<UsdReader>(new UsdReader(pFileName, 
-                                                        host));
-    MriGeoPluginResult res = reader->Load(Entity);
-    sUsdLog = reader->GetLog();
-    *ppMessagesOut = sUsdLog.c_str();
-    return res;
-    
-
+    return impl->load(Entity, pFileName, ppMessagesOut);
 }
 
 
@@ -81,13 +205,14 @@ MriGeoPluginResult load(MriGeoEntityHandle Entity,
 // Register the supported formats
 MriFileFormatDesc *supportedFormats(int *pNumFormatsOut)
 {
-    static MriFileFormatDesc formats[4] = {
+    static MriFileFormatDesc formats[5] = {
         {"usd", "USD poseCache file (ASCII or binary)."},
         {"usda", "ASCII USD poseCache file."},
         {"usdc", "binary USD poseCache file."},
-        {"usdz", "zipped USD poseCache file."}
+        {"usdz", "zipped USD poseCache file."},
+        {"usdlist", "list of USD files, imported together."}
     };
-    *pNumFormatsOut = 4;
+    *pNumFormatsOut = 5;
     return formats;
 }
 
@@ -98,103 +223,10 @@ MriFileFormatDesc *supportedFormats(int *pNumFormatsOut)
 MriGeoPluginResult getSettings(MriUserItemHandle SettingsHandle, 
         const char *pFileName)
 {
-    
-    host.trace("[UsdPlugin] getSettings %s\n", pFileName);
-
-    boost::shared_ptr<UsdReader> reader;
-
-    // Check the extension
-    if((!TfStringEndsWith(pFileName, ".usd")) &&
-       (!TfStringEndsWith(pFileName, ".usda")) &&
-       (!TfStringEndsWith(pFileName, ".usdc")) &&
-       (!TfStringEndsWith(pFileName, ".usdz"))) {
-        host.trace("[UsdPlugin] Unrecognized extension. Failed to getSettings for %s\n", pFileName);
+    const ImplSuite *impl = _GetImpl();
+    if (!impl)
         return MRI_GPR_FAILED;
-    }
-    // else
-    
-    reader = boost::shared_ptr<UsdReader>(new UsdReader(pFileName, 
-                                                        host));
-
-    // Load option
-    MriAttributeValue LoadValue;
-    LoadValue.m_Type = MRI_ATTR_STRING_LIST;
-    LoadValue.m_pString = "First Found\nAll Models\nSpecified Models in Model Names";
-    host.setAttribute(SettingsHandle,
-        "Load",
-        &LoadValue);
-
-    // Merge option
-    MriAttributeValue MergeValue;
-    MergeValue.m_Type = MRI_ATTR_STRING_LIST;
-    MergeValue.m_pString = "Merge Models\nKeep Models Separate";
-    host.setAttribute(SettingsHandle,
-        "Merge Type",
-        &MergeValue);
-
-    // Model option
-    MriAttributeValue ModelValue;
-    ModelValue.m_Type = MRI_ATTR_STRING;
-    ModelValue.m_pString = "";
-    host.setAttribute(SettingsHandle,
-        "Model Names",
-        &ModelValue);
-
-    MriGeoPluginResult res = reader->GetSettings(SettingsHandle);
-
-    // Mapping scheme
-    MriAttributeValue MappingSchemeValue;
-    MappingSchemeValue.m_Type = MRI_ATTR_STRING_LIST;
-    MappingSchemeValue.m_pString = UsdReader::kMappingSchemeOptions.c_str();
-    host.setAttribute(SettingsHandle, "Mapping Scheme", &MappingSchemeValue);
-
-    // frame number
-    MriAttributeValue FrameNumberValue;
-    FrameNumberValue.m_Type = MRI_ATTR_STRING;
-    FrameNumberValue.m_pString = "1";
-    host.setAttribute(SettingsHandle, "Frame Numbers", &FrameNumberValue);
-    
-    // Gprim Names
-    MriAttributeValue GprimValue;
-    GprimValue.m_Type = MRI_ATTR_STRING;
-    GprimValue.m_pString = "";
-    host.setAttribute(SettingsHandle,
-        "Gprim Names",
-        &GprimValue);
-
-    // Variants
-    MriAttributeValue variantsValue;
-    variantsValue.m_Type = MRI_ATTR_STRING;
-    variantsValue.m_pString = "";
-    host.setAttribute(SettingsHandle,
-        "Variants",
-        &variantsValue);
-
-    // Keep centered
-    MriAttributeValue KeepCenteredValue;
-    KeepCenteredValue.m_Type = MRI_ATTR_BOOL;
-    KeepCenteredValue.m_Int = 0;
-    host.setAttribute(SettingsHandle, "Keep Centered", &KeepCenteredValue);
-
-    // Mari y up
-    MriAttributeValue ConformToMariY;
-    ConformToMariY.m_Type = MRI_ATTR_BOOL;
-    ConformToMariY.m_Int = 1;
-    host.setAttribute(SettingsHandle, "Conform to Mari Y as up", &ConformToMariY);
-
-    // Include Invisible
-    MriAttributeValue IncludeInvisibleValue;
-    IncludeInvisibleValue.m_Type = MRI_ATTR_BOOL;
-    IncludeInvisibleValue.m_Int = 0;
-    host.setAttribute(SettingsHandle, "Include Invisible", &IncludeInvisibleValue);
-
-    // Include CreateFaceSelectionGroups
-    MriAttributeValue CreateFaceSelectionGroupsValue;
-    CreateFaceSelectionGroupsValue.m_Type = MRI_ATTR_BOOL;
-    CreateFaceSelectionGroupsValue.m_Int = 0;
-    host.setAttribute(SettingsHandle, "Create Face Selection Group per mesh", &CreateFaceSelectionGroupsValue);
-
-    return res;
+    return impl->getSettings(SettingsHandle, pFileName);
 }
 
 //------------------------------------------------------------------------------
@@ -210,6 +242,9 @@ const void *getPluginSuite()
 
 void flushPluginSuite()
 {
+    lock_guard<mutex> lock(sImplMutex);
+    if (sImplLoaded)
+        sImpl.flush();
 }
 
 //------------------------------------------------------------------------------
@@ -235,6 +270,12 @@ FnPluginStatus setHost(const FnPluginHost *pHost)
 
     host.trace("[UsdPlugin] Plug-in connected to host '%s' version '%s'"
             "(%u)", pHost->name, pHost->versionStr, pHost->versionInt);
+
+    // Load the importer now rather than on the first import, which also
+    // starts its warm-up
+    const char *preload = getenv("MARI_USD_PRELOAD");
+    if (preload && string(preload) == "1")
+        _GetImpl(true);
     return FnPluginStatusOK;
 }
 
@@ -0,0 +1,81 @@
+// These files were initially authored by Pixar.
+// In 2019, Foundry and Pixar agreed Foundry should maintain and curate
+// these plug-ins, and they moved to
+// https://github.com/TheFoundryVisionmongers/mariusdplugins
+// under the same Modified Apache 2.0 license as the main USD library,
+// as shown below.
+//
+// Copyright 2019 Pixar
+//
+// Licensed under the Apache License, Version 2.0 (the "Apache License")
+// with the following modification; you may not use this file except in
+// compliance with the Apache License and the following modification to it:
+// Section 6. Trademarks. is deleted and replaced with:
+//
+// 6. Trademarks. This License does not grant permission to use the trade
+//    names, trademarks, service marks, or product names of the Licensor
+//    and its affiliates, except as required to comply with Section 4(c) of
+//    the License and to reproduce the content of the NOTICE file.
+//
+// You may obtain a copy of the Apache License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the Apache License with the above modification is
+// distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied. See the Apache License for the specific
+// language governing permissions and limitations under the Apache License.
+//
+
+// Python bindings of UsdProbe, built as the _usdProbe module.
+// python/usdProbe.py wraps it and falls back to Sdf when it is missing.
+
+#include "UsdProbe.h"
+
+#include <boost/python.hpp>
+
+using namespace boost::python;
+
+static dict
+_Probe(const std::string &fileName, bool scanPrims)
+{
+    UsdProbe::Options options;
+    options.scanPrims = scanPrims;
+    UsdProbe::Result result = UsdProbe::Probe(fileName, options);
+
+    dict uvSets;
+    for (const auto &it : result.uvSets)
+        uvSets[it.first] = it.second;
+
+    list subLayers;
+    for (const std::string &subLayer : result.subLayers)
+        subLayers.append(subLayer);
+
+    dict info;
+    info["valid"] = result.valid;
+    info["error"] = result.error;
+    info["isCrate"] = result.isCrate;
+    info["defaultPrim"] = result.defaultPrim;
+    info["upAxis"] = result.upAxis;
+    info["timeCodesPerSecond"] = result.timeCodesPerSecond;
+    info["framesPerSecond"] = result.framesPerSecond;
+    info["hasTimeRange"] = result.hasTimeRange;
+    info["startTimeCode"] = result.startTimeCode;
+    info["endTimeCode"] = result.endTimeCode;
+    info["subLayers"] = subLayers;
+    info["primsScanned"] = result.primsScanned;
+    info["primCount"] = result.primCount;
+    info["meshCount"] = result.meshCount;
+    info["uvSets"] = uvSets;
+    info["needsComposition"] = result.needsComposition;
+    info["selfContained"] = result.IsSelfContained();
+    return info;
+}
+
+BOOST_PYTHON_MODULE(_usdProbe)
+{
+    def("probe", &_Probe, (arg("fileName"), arg("scanPrims") = true),
+        "Returns a dict of cheap facts about a USD file, read from its root "
+        "layer without composing a stage.");
+}
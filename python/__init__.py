@@ -20,6 +20,7 @@
 # KIND, either express or implied. See the Apache License for the specific
 # language governing permissions and limitations under the Apache License.
 
+from . import usdProbe
 from . import usdShadeExport
 from . import usdExportManagerTab
 from . import usdShader
@@ -27,6 +27,7 @@ import PySide2.QtWidgets as widgets
 qt = core.Qt
 
 from fnpxr import Sdf, Usd, UsdGeom
+from . import usdProbe
 
 USER_ROLE_PATH = qt.UserRole
 
@@ -302,7 +303,8 @@ class UsdLoaderWidget(widgets.QWidget):
         self.merge_type_box = widgets.QComboBox()
         self.merge_type_box.setToolTip("""Specify whether to merge the models in the file into a single Object
   - Merge Models : Merge the models into a single Object
-  - Keep Models Separate : Keep the models separate""")
+  - Keep Models Separate : Keep the models separate
+  - Consolidate Meshes : Merge the models, and concatenate compatible meshes into as few mesh objects as possible""")
         options_layout.addWidget(widgets.QLabel("Merge Type"), 0, 0)
         options_layout.addWidget(self.merge_type_box, 0, 1)
 
@@ -366,8 +368,15 @@ class UsdLoaderWidget(widgets.QWidget):
         self.uv_set_box.clear()
         [self.uv_set_box.addItem(line) for line in attr.splitlines()]
 
-        # Update the tree widget
+        # Show the frame range authored in the file, read from the layer metadata only
         mesh_path = mari.app.currentMeshPathInGeoLoader()
+        info = usdProbe.probe(mesh_path, scan_prims=False)
+        if info["valid"] and info["hasTimeRange"]:
+            self.frame_numbers_edit.setToolTip("""Specify the frame numbers to load (file range: %g-%g)""" % (info["startTimeCode"], info["endTimeCode"]))
+        else:
+            self.frame_numbers_edit.setToolTip("""Specify the frame numbers to load""")
+
+        # Update the tree widget
         root_layer = Sdf.Layer.FindOrOpen(mesh_path)
         stage = Usd.Stage.Open(root_layer)
         self.tree_widget.populate(stage)
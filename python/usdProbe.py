@@ -0,0 +1,108 @@
+# Copyright 2022 Foundry
+#
+# Licensed under the Apache License, Version 2.0 (the "Apache License")
+# with the following modification; you may not use this file except in
+# compliance with the Apache License and the following modification to it:
+# Section 6. Trademarks. is deleted and replaced with:
+#
+# 6. Trademarks. This License does not grant permission to use the trade
+#    names, trademarks, service marks, or product names of the Licensor
+#    and its affiliates, except as required to comply with Section 4(c) of
+#    the License and to reproduce the content of the NOTICE file.
+#
+# You may obtain a copy of the Apache License at
+#
+#     http:#www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the Apache License with the above modification is
+# distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied. See the Apache License for the specific
+# language governing permissions and limitations under the Apache License.
+
+
+"""Cheap facts about a USD file, read from its root layer without composing a stage.
+
+Uses the _usdProbe module built with the USD import plugin when available, which also scans the prim specs of crate
+files, and falls back to reading the layer metadata through Sdf otherwise.
+"""
+
+try:
+    from fnpxr import Sdf, UsdGeom
+except ImportError:
+    from pxr import Sdf, UsdGeom
+
+try:
+    import _usdProbe
+except ImportError:
+    _usdProbe = None
+
+
+def _sdfProbe(file_path):
+    """Reads the layer metadata of the given file through Sdf.
+
+    Args:
+        file_path (str): Path of the USD file
+    Returns:
+        (dict): Same keys as probe(), without the prim spec counts.
+    """
+    info = {
+        "valid": False,
+        "error": "",
+        "isCrate": False,
+        "defaultPrim": "",
+        "upAxis": "",
+        "timeCodesPerSecond": 24.0,
+        "framesPerSecond": 24.0,
+        "hasTimeRange": False,
+        "startTimeCode": 0.0,
+        "endTimeCode": 0.0,
+        "subLayers": [],
+        "primsScanned": False,
+        "primCount": 0,
+        "meshCount": 0,
+        "uvSets": {},
+        "needsComposition": False,
+        "selfContained": False,
+    }
+    try:
+        with open(file_path, "rb") as f:
+            info["isCrate"] = f.read(8) == b"PXR-USDC"
+        layer = Sdf.Layer.OpenAsAnonymous(file_path, True)
+    except Exception as e:
+        info["error"] = str(e)
+        return info
+    if not layer:
+        info["error"] = "Cannot open %s" % file_path
+        return info
+
+    info["defaultPrim"] = layer.defaultPrim
+    up_axis = layer.pseudoRoot.GetInfo(UsdGeom.Tokens.upAxis) if layer.pseudoRoot.HasInfo(UsdGeom.Tokens.upAxis) else ""
+    info["upAxis"] = str(up_axis)
+    if layer.HasTimeCodesPerSecond():
+        info["timeCodesPerSecond"] = layer.timeCodesPerSecond
+    if layer.HasFramesPerSecond():
+        info["framesPerSecond"] = layer.framesPerSecond
+    info["hasTimeRange"] = layer.HasStartTimeCode() and layer.HasEndTimeCode()
+    if info["hasTimeRange"]:
+        info["startTimeCode"] = layer.startTimeCode
+        info["endTimeCode"] = layer.endTimeCode
+    info["subLayers"] = list(layer.subLayerPaths)
+    info["valid"] = True
+    return info
+
+
+def probe(file_path, scan_prims=True):
+    """Returns cheap facts about the given USD file, without composing a stage.
+
+    Args:
+        file_path (str): Path of the USD file
+        scan_prims (bool): Whether to scan the prim specs of crate files. Ignored without the _usdProbe module.
+    Returns:
+        (dict): "valid", "error", "isCrate", "defaultPrim", "upAxis", "timeCodesPerSecond", "framesPerSecond",
+            "hasTimeRange", "startTimeCode", "endTimeCode", "subLayers", and from the prim specs "primsScanned",
+            "primCount", "meshCount", "uvSets" (name to mesh count), "needsComposition" and "selfContained".
+    """
+    if _usdProbe is not None:
+        return _usdProbe.probe(file_path, scan_prims)
+    return _sdfProbe(file_path)
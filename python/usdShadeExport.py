@@ -25,6 +25,7 @@ import os
 
 import mari
 from pxr import Sdf, Usd, UsdShade, Tf, UsdGeom
+from . import usdProbe
 
 USD_SHADER_EXPORT_FUNCTIONS = {}
 MARI_TO_USD_SHADER_MAPPING = {}
@@ -927,13 +928,12 @@ def payloadDefaultRootName(payload_file_path):
         (str): The default root name of the given payload file path.
     """
     if os.path.exists(payload_file_path):
-        try:
-            payload_stage = Usd.Stage.Open(payload_file_path)
-            payload_default_prim = payload_stage.GetDefaultPrim()
-            payload_root_name = str(payload_default_prim.GetPath())
-            return payload_root_name
-        except Exception as e:
-            _debuglog("Warning: The Payload file is not a USD file : %s" % str(e))
+        # Only the layer metadata is needed, there is no need to compose a stage
+        info = usdProbe.probe(payload_file_path, scan_prims=False)
+        if not info["valid"]:
+            _debuglog("Warning: The Payload file is not a USD file : %s" % info["error"])
+        elif info["defaultPrim"]:
+            return "/" + info["defaultPrim"]
     geo_entity = mari.geo.current()
     if geo_entity and geo_entity.hasMetadata("StagePrimPath"):
         return geo_entity.metadata("StagePrimPath")